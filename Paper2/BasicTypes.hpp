@@ -35,6 +35,8 @@ using ColorRGBA = crunch::ColorRGBA;
 using ColorHSB = crunch::ColorHSB;
 using ColorHSBA = crunch::ColorHSBA;
 using DashArray = stick::DynamicArray<Float>;
+using Polygon = stick::DynamicArray<Vec2f>;
+using PolygonArray = stick::DynamicArray<Polygon>;
 } // namespace paper
 
 #endif // PAPER_BASICTYPES_HPP
@@ -4,10 +4,14 @@
 #include <Paper2/Symbol.hpp>
 
 #include <Paper2/BinFormat/BinFormatImport.hpp>
+#include <Paper2/Private/Parallel.hpp>
+#include <Paper2/Private/PathIntersections.hpp>
 #include <Paper2/SVG/SVGImport.hpp>
 
 #include <Stick/FileUtilities.hpp>
 
+#include <atomic>
+
 namespace paper
 {
 using namespace stick;
@@ -161,4 +165,96 @@ RadialGradientPtr Document::createRadialGradient(const Vec2f & _from, const Vec2
     return makeShared<RadialGradient>(*m_alloc, _from, _to);
 }
 
+IntersectionArray Document::intersectAll(const Path * const * _paths,
+                                         Size _count,
+                                         bool _bMultithreaded) const
+{
+    IntersectionArray ret(*m_alloc);
+    detail::PathIntersections::intersectAll(_paths, _count, ret, _bMultithreaded);
+    return ret;
+}
+
+void Document::contains(const Path * const * _paths,
+                        Size _pathCount,
+                        const Vec2f * _points,
+                        Size _pointCount,
+                        bool * _outResults,
+                        bool _bMultithreaded) const
+{
+    for (Size i = 0; i < _pathCount; ++i)
+        _paths[i]->contains(_points, _pointCount, _outResults + i * _pointCount, _bMultithreaded);
+}
+
+// computes the new segments of all paths with _fn(path, outSegments) and sets them afterwards.
+// Only the computation runs in parallel, setting the segments notifies the parents of the paths
+// which may be shared. Paths are handed out one at a time as they can differ a lot in size.
+template <class F>
+static void processPaths(
+    Path * const * _paths, Size _count, bool _bMultithreaded, Allocator & _alloc, F _fn)
+{
+    DynamicArray<SegmentDataArray> results(_alloc);
+    results.reserve(_count);
+    for (Size i = 0; i < _count; ++i)
+        results.append(SegmentDataArray(_paths[i]->segmentData().allocator()));
+    DynamicArray<bool> changed(_count, _alloc);
+
+    Size threadCount = _bMultithreaded ? detail::hardwareThreadCount() : 1;
+    std::atomic<Size> next(0);
+    detail::parallelFor(threadCount, threadCount, [&](Size, Size, Size) {
+        for (Size i = next++; i < _count; i = next++)
+            changed[i] = _fn(_paths[i], results[i]);
+    });
+
+    for (Size i = 0; i < _count; ++i)
+    {
+        if (changed[i])
+            _paths[i]->swapSegments(results[i], _paths[i]->isClosed());
+    }
+}
+
+void Document::simplifyPaths(Path * const * _paths,
+                             Size _count,
+                             Float _tolerance,
+                             bool _bMultithreaded)
+{
+    processPaths(_paths,
+                 _count,
+                 _bMultithreaded,
+                 allocator(),
+                 [_tolerance](Path * _p, SegmentDataArray & _out) {
+                     return _p->simplifiedSegments(_tolerance, _out);
+                 });
+}
+
+void Document::flattenPaths(Path * const * _paths,
+                            Size _count,
+                            Float _angleTolerance,
+                            Float _minDistance,
+                            Size _maxRecursion,
+                            bool _bMultithreaded)
+{
+    processPaths(_paths,
+                 _count,
+                 _bMultithreaded,
+                 allocator(),
+                 [&](Path * _p, SegmentDataArray & _out) {
+                     return _p->flattenedSegments(
+                         _angleTolerance, _minDistance, _maxRecursion, _out);
+                 });
+}
+
+void Document::smoothPaths(Path * const * _paths,
+                           Size _count,
+                           Smoothing _type,
+                           bool _bMultithreaded)
+{
+    processPaths(_paths,
+                 _count,
+                 _bMultithreaded,
+                 allocator(),
+                 [_type](Path * _p, SegmentDataArray & _out) {
+                     return _p->smoothedSegments(_type, _out);
+                 });
+}
+
 } // namespace paper
@@ -2,12 +2,12 @@
 #define PAPER_DOCUMENT_HPP
 
 #include <Paper2/Item.hpp>
+#include <Paper2/Path.hpp>
 #include <Paper2/SVG/SVGImportResult.hpp>
 #include <Stick/UniquePtr.hpp>
 
 namespace paper
 {
-class Path;
 class Group;
 class Symbol;
 
@@ -65,6 +65,47 @@ class STICK_API Document : public Item
     
     RadialGradientPtr createRadialGradient(const Vec2f & _from, const Vec2f & _to);
 
+    // intersections between all pairs of the provided paths (including their children) in
+    // document space. Gives the same result as calling _paths[i]->intersections(_paths[j]) for
+    // all i < j, but all curves share one broadphase and each path is only transformed once.
+    // If _bMultithreaded is true, the curve intersection tests are spread over all hardware
+    // threads.
+    IntersectionArray intersectAll(const Path * const * _paths,
+                                   Size _count,
+                                   bool _bMultithreaded = false) const;
+
+    // classifies _pointCount points against each of the provided paths. The result for point j
+    // and path i is written to _outResults[i * _pointCount + j]. Same as calling
+    // Path::contains for every path and point.
+    void contains(const Path * const * _paths,
+                  Size _pathCount,
+                  const Vec2f * _points,
+                  Size _pointCount,
+                  bool * _outResults,
+                  bool _bMultithreaded = false) const;
+
+    // batch versions of Path::simplify, Path::flatten and Path::smooth (children are not
+    // included). The new segments of all paths are computed first, spread over all hardware
+    // threads if _bMultithreaded is true, and then set on the paths in order. The results are
+    // the same as calling the path functions one by one. Each path may only be passed once and
+    // the document allocator needs to be thread safe.
+    void simplifyPaths(Path * const * _paths,
+                       Size _count,
+                       Float _tolerance = 2.5,
+                       bool _bMultithreaded = false);
+
+    void flattenPaths(Path * const * _paths,
+                      Size _count,
+                      Float _angleTolerance = 0.25,
+                      Float _minDistance = 0.0,
+                      Size _maxRecursion = 32,
+                      bool _bMultithreaded = false);
+
+    void smoothPaths(Path * const * _paths,
+                     Size _count,
+                     Smoothing _type = Smoothing::Asymmetric,
+                     bool _bMultithreaded = false);
+
   private:
     // documents can't be cloned for now
     Document * clone() const final;
@@ -1104,7 +1104,9 @@ void Item::hierarchyString(String & _outputString, Size _indent) const
         child->hierarchyString(_outputString, _indent + 1);
 }
 
-HitTestSettings::HitTestSettings() : curveTolerance(2.5f), mode(HitTestFill | HitTestCurves)
+HitTestSettings::HitTestSettings() :
+    curveTolerance(2.5f),
+    mode(HitTestFill | HitTestCurves)
 {
 }
 
@@ -1118,6 +1120,11 @@ bool HitTestSettings::testCurves() const
     return (mode & HitTestCurves) == HitTestCurves;
 }
 
+bool HitTestSettings::testStroke() const
+{
+    return (mode & HitTestStroke) == HitTestStroke;
+}
+
 Maybe<HitTestResult> Item::hitTest(const Vec2f & _pos, const HitTestSettings & _settings) const
 {
     HitTestResultArray tmp(m_children.allocator());
@@ -18,7 +18,10 @@ class CurveLocation;
 enum HitTestMode
 {
     HitTestFill = 1 << 0,
-    HitTestCurves = 1 << 1
+    HitTestCurves = 1 << 1,
+    // the area covered by the stroke, including width, joins, caps and dashes. not part of the
+    // default settings
+    HitTestStroke = 1 << 2
 };
 
 struct STICK_API HitTestResult
@@ -33,6 +36,7 @@ struct STICK_API HitTestSettings
 
     bool testFill() const;
     bool testCurves() const;
+    bool testStroke() const;
 
     Float curveTolerance;
     UInt32 mode; // HitTestMode mask
@@ -1,11 +1,19 @@
 #include <Paper2/Document.hpp>
+#include <Paper2/Private/DashPattern.hpp>
 #include <Paper2/Private/JoinAndCap.hpp>
+#include <Paper2/Private/Parallel.hpp>
 #include <Paper2/Private/PathFitter.hpp>
 #include <Paper2/Private/PathFlattener.hpp>
+#include <Paper2/Private/PathIntersections.hpp>
+#include <Paper2/Private/ScratchAllocator.hpp>
+#include <Paper2/Private/StrokeOutliner.hpp>
+#include <Paper2/Private/TransformedSegmentView.hpp>
 
 #include <Crunch/MatrixFunc.hpp>
 #include <Crunch/StringConversion.hpp>
 
+#include <algorithm>
+
 namespace paper
 {
 using namespace stick;
@@ -392,6 +400,89 @@ Error arcBy(SegmentDataArray & _segs, const Vec2f & _to, bool _bClockwise)
     SegmentData & current = _segs.last();
     return arcTo(_segs, current.position + _to, _bClockwise);
 }
+
+void transform(const Mat32f & _transform, const SegmentData * _in, SegmentData * _out, Size _count)
+{
+    static_assert(sizeof(SegmentData) == sizeof(Float) * 6, "SegmentData needs to be tightly packed");
+
+    // a segment is just three points in a row, so we treat the segments as one flat array of
+    // x, y pairs. The loop has no dependencies between iterations, which lets the compiler
+    // vectorize it.
+    const Float a = _transform[0].x;
+    const Float b = _transform[0].y;
+    const Float c = _transform[1].x;
+    const Float d = _transform[1].y;
+    const Float tx = _transform[2].x;
+    const Float ty = _transform[2].y;
+
+    const Float * in = reinterpret_cast<const Float *>(_in);
+    Float * out = reinterpret_cast<Float *>(_out);
+    Size count = _count * 6;
+    for (Size i = 0; i < count; i += 2)
+    {
+        Float x = in[i];
+        Float y = in[i + 1];
+        out[i] = a * x + c * y + tx;
+        out[i + 1] = b * x + d * y + ty;
+    }
+}
+
+Moments moments(const SegmentData * _segments, Size _count, bool _bClosed)
+{
+    // Green's theorem turns each moment into the integral of f(x, y) * (x * y' - y * x') along the
+    // curves, with f = 1 / 2, x / 3, y / 3, x^2 / 4, y^2 / 4 and x * y / 4. For cubics these are
+    // polynomials of degree 10 at most, which 6 point gauss legendre quadrature integrates
+    // exactly.
+    static const Float64 s_nodes[6] = { 0.0337652428984240, 0.1693953067668677,
+                                        0.3806904069584015, 0.6193095930415985,
+                                        0.8306046932331323, 0.9662347571015760 };
+    static const Float64 s_weights[6] = { 0.0856622461895852, 0.1803807865240693,
+                                          0.2339569672863455, 0.2339569672863455,
+                                          0.1803807865240693, 0.0856622461895852 };
+
+    Float64 m[6] = { 0, 0, 0, 0, 0, 0 };
+    // open paths are closed with a straight line from the last to the first segment
+    Size curveCount = _count < 2 ? 0 : _count;
+    for (Size i = 0; i < curveCount; ++i)
+    {
+        const SegmentData & a = _segments[i];
+        const SegmentData & b = _segments[(i + 1) % _count];
+        bool bChord = !_bClosed && i == _count - 1;
+        const Vec2f & h0 = bChord ? a.position : a.handleOut;
+        const Vec2f & h1 = bChord ? b.position : b.handleIn;
+
+        // power basis, p(t) = p0 + c1 * t + c2 * t^2 + c3 * t^3
+        Float64 x0 = a.position.x;
+        Float64 y0 = a.position.y;
+        Float64 cx1 = 3.0 * ((Float64)h0.x - x0);
+        Float64 cy1 = 3.0 * ((Float64)h0.y - y0);
+        Float64 cx2 = 3.0 * (x0 - 2.0 * h0.x + h1.x);
+        Float64 cy2 = 3.0 * (y0 - 2.0 * h0.y + h1.y);
+        Float64 cx3 = (Float64)b.position.x - x0 + 3.0 * ((Float64)h0.x - h1.x);
+        Float64 cy3 = (Float64)b.position.y - y0 + 3.0 * ((Float64)h0.y - h1.y);
+
+        for (Size j = 0; j < 6; ++j)
+        {
+            Float64 t = s_nodes[j];
+            Float64 x = x0 + t * (cx1 + t * (cx2 + t * cx3));
+            Float64 y = y0 + t * (cy1 + t * (cy2 + t * cy3));
+            Float64 dx = cx1 + t * (2.0 * cx2 + t * 3.0 * cx3);
+            Float64 dy = cy1 + t * (2.0 * cy2 + t * 3.0 * cy3);
+            Float64 w = s_weights[j] * (x * dy - y * dx);
+            m[0] += w;
+            m[1] += w * x;
+            m[2] += w * y;
+            m[3] += w * x * x;
+            m[4] += w * y * y;
+            m[5] += w * x * y;
+        }
+    }
+
+    return { (Float)(m[0] / 2.0),
+             Vec2f(m[1] / 3.0, m[2] / 3.0),
+             Vec2f(m[3] / 4.0, m[4] / 4.0),
+             (Float)(m[5] / 4.0) };
+}
 } // namespace segments
 
 Path::Path(stick::Allocator & _alloc, Document * _document, const char * _name) :
@@ -399,6 +490,11 @@ Path::Path(stick::Allocator & _alloc, Document * _document, const char * _name)
     m_segmentData(_alloc),
     m_curveData(_alloc),
     m_bIsClosed(false),
+    m_curveOffsets(_alloc),
+    m_arcLengths(_alloc),
+    m_flattened(_alloc),
+    m_strokeOutline(_alloc),
+    m_bStrokeOutlineDirty(true),
     m_bGeometryDirty(false),
     m_bContoursDirty(false)
 {
@@ -860,7 +956,77 @@ static Int64 smoothIndex(Int64 _idx, Int64 _length, bool _bClosed)
                     _length - 1);
 }
 
-void Path::smooth(Int64 _from, Int64 _to, Smoothing _type)
+namespace
+{
+// one row a * x[i - 1] + b * x[i] + c * x[i + 1] = d of a tridiagonal system
+struct TridiagonalRow
+{
+    Float a;
+    Float b;
+    Float c;
+    Vec2f d;
+};
+
+// solves the system in place with the Thomas algorithm, the solution ends up in d.
+void solveTridiagonal(TridiagonalRow * _rows, Int64 _count)
+{
+    for (Int64 i = 1; i < _count; i++)
+    {
+        Float m = _rows[i].a / _rows[i - 1].b;
+        _rows[i].b -= m * _rows[i - 1].c;
+        _rows[i].d -= _rows[i - 1].d * m;
+    }
+
+    _rows[_count - 1].d = _rows[_count - 1].d / _rows[_count - 1].b;
+    for (Int64 i = _count - 2; i >= 0; i--)
+        _rows[i].d = (_rows[i].d - _rows[i + 1].d * _rows[i].c) / _rows[i].b;
+}
+
+// In the algorithm we treat these 3 cases:
+// - left most segment (L)
+// - internal segments (I)
+// - right most segment (R)
+//
+// continuous:
+// a = 0 (L), 1 (I), 2 (R)
+// b = 2 (L), 4 (I), 7 (R)
+// c = 1 (L), 1 (I), 0 (R)
+// u = 1 (L), 4 (I), 8 (R)
+// v = 2 (L), 2 (I), 1 (R)
+//
+// asymmetric:
+// a = 0 (L), 1 (I), 1 (R)
+// b = 2 (L), 4 (I), 2 (R)
+// c = 1 (L), 1 (I), 0 (R)
+// u = 1 (L), 4 (I), 3 (R)
+// v = 2 (L), 2 (I), 0 (R)
+//
+// the rows solve for the first control point of curve i between knot _k0 and knot _k1.
+TridiagonalRow leftSmoothRow(const Vec2f & _k0, const Vec2f & _k1)
+{
+    return { 0, 2, 1, _k0 + _k1 * 2 };
+}
+
+TridiagonalRow internalSmoothRow(const Vec2f & _k0, const Vec2f & _k1)
+{
+    return { 1, 4, 1, _k0 * 4 + _k1 * 2 };
+}
+
+TridiagonalRow rightSmoothRow(const Vec2f & _k0, const Vec2f & _k1, bool _bAsymmetric)
+{
+    return _bAsymmetric ? TridiagonalRow{ 1, 2, 0, _k0 * 3 } :
+                          TridiagonalRow{ 2, 7, 0, _k0 * 8 + _k1 };
+}
+} // namespace
+
+namespace segments
+{
+bool smooth(SegmentData * _segments,
+            Size _count,
+            bool _bClosed,
+            Int64 _from,
+            Int64 _to,
+            Smoothing _type)
 {
     // Continuous smoothing approach based on work by Lubos Brieda,
     // Particle In Cell Consulting LLC, but further simplified by
@@ -873,18 +1039,19 @@ void Path::smooth(Int64 _from, Int64 _to, Smoothing _type)
     // that use this algorithm: continuous and asymmetric. asymmetric
     // was the only approach available in v0.9.25 & below.
 
-    Int64 from = smoothIndex(_from, m_segmentData.count(), isClosed());
-    Int64 to = smoothIndex(_to, m_segmentData.count(), isClosed());
+    Int64 count = _count;
+    Int64 from = smoothIndex(_from, count, _bClosed);
+    Int64 to = smoothIndex(_to, count, _bClosed);
     if (from > to)
     {
-        if (isClosed())
+        if (_bClosed)
         {
-            from -= m_segmentData.count();
+            from -= count;
         }
         else
         {
-            Int64 tmp = _from;
-            from = _to;
+            Int64 tmp = from;
+            from = to;
             to = tmp;
         }
     }
@@ -894,7 +1061,7 @@ void Path::smooth(Int64 _from, Int64 _to, Smoothing _type)
         bool bAsymmetric = _type == Smoothing::Asymmetric;
         Int64 amount = to - from + 1;
         Int64 n = amount - 1;
-        bool bLoop = isClosed() && _from == 0 && to == m_segmentData.count() - 1;
+        bool bLoop = _bClosed && from == 0 && to == count - 1;
 
         // Overlap by up to 4 points on closed paths since a current
         // segment is affected by its 4 neighbors on both sides (?).
@@ -902,114 +1069,227 @@ void Path::smooth(Int64 _from, Int64 _to, Smoothing _type)
         Int64 paddingLeft = padding;
         Int64 paddingRight = padding;
 
-        if (!isClosed())
+        if (!_bClosed)
         {
             // If the path is open and a range is defined, try using a
             // padding of 1 on either side.
             paddingLeft = min((Int64)1, from);
-            paddingRight = min((Int64)1, (Int64)m_segmentData.count() - to - 1);
+            paddingRight = min((Int64)1, count - to - 1);
         }
 
         n += paddingLeft + paddingRight;
         if (n <= 1)
-            return;
-
-        DynamicArray<Vec2f> knots(n + 1);
-
-        for (Int64 i = 0, j = _from - paddingLeft; i <= n; i++, j++)
-        {
-            knots[i] =
-                m_segmentData[(j < 0 ? j + m_segmentData.count() : j) % m_segmentData.count()]
-                    .position;
-        }
-
-        // In the algorithm we treat these 3 cases:
-        // - left most segment (L)
-        // - internal segments (I)
-        // - right most segment (R)
-        //
-        // In both the continuous and asymmetric method, c takes these
-        // values and can hence be removed from the loop starting in n - 2:
-        // c = 1 (L), 1 (I), 0 (R)
-        //
-        // continuous:
-        // a = 0 (L), 1 (I), 2 (R)
-        // b = 2 (L), 4 (I), 7 (R)
-        // u = 1 (L), 4 (I), 8 (R)
-        // v = 2 (L), 2 (I), 1 (R)
-        //
-        // asymmetric:
-        // a = 0 (L), 1 (I), 1 (R)
-        // b = 2 (L), 4 (I), 2 (R)
-        // u = 1 (L), 4 (I), 3 (R)
-        // v = 2 (L), 2 (I), 0 (R)
-
-        // (L): u = 1, v = 2
-        Float x = knots[0].x + 2 * knots[1].x;
-        Float y = knots[0].y + 2 * knots[1].y;
-        Float f = 2;
-        Float n1 = n - 1;
-        DynamicArray<Float> rx(n + 1);
-        rx[0] = x;
-        DynamicArray<Float> ry(n + 1);
-        ry[0] = y;
-        DynamicArray<Float> rf(n + 1);
-        rf[0] = f;
-
-        DynamicArray<Float> px(n + 1);
-        DynamicArray<Float> py(n + 1);
-
-        // Solve with the Thomas algorithm
-        for (Int64 i = 1; i < n; i++)
-        {
-            bool bInternal = i < n1;
-            // internal--(I)  asymmetric--(R) (R)--continuous
-            Float a = bInternal ? 1 : bAsymmetric ? 1 : 2;
-            Float b = bInternal ? 4 : bAsymmetric ? 2 : 7;
-            Float u = bInternal ? 4 : bAsymmetric ? 3 : 8;
-            Float v = bInternal ? 2 : bAsymmetric ? 0 : 1;
-            Float m = a / f;
-            f = rf[i] = b - m;
-            x = rx[i] = u * knots[i].x + v * knots[i + 1].x - m * x;
-            y = ry[i] = u * knots[i].y + v * knots[i + 1].y - m * y;
-        }
+            return false;
 
-        px[n1] = rx[n1] / rf[n1];
-        py[n1] = ry[n1] / rf[n1];
-        for (Int64 i = n - 2; i >= 0; i--)
-        {
-            px[i] = (rx[i] - px[i + 1]) / rf[i];
-            py[i] = (ry[i] - py[i + 1]) / rf[i];
-        }
-        px[n] = (3 * knots[n].x - px[n1]) / 2;
-        py[n] = (3 * knots[n].y - py[n1]) / 2;
+        auto knot = [&](Int64 _i) -> const Vec2f & {
+            Int64 j = from - paddingLeft + _i;
+            return _segments[(j < 0 ? j + count : j) % count].position;
+        };
+
+        // the rows live in thread local scratch memory, so smoothing does not allocate once
+        // the scratch allocator is warmed up.
+        detail::ScratchScope scratch;
+        DynamicArray<TridiagonalRow> rows(scratch.allocator());
+        rows.resize(n);
+        rows[0] = leftSmoothRow(knot(0), knot(1));
+        for (Int64 i = 1; i < n - 1; i++)
+            rows[i] = internalSmoothRow(knot(i), knot(i + 1));
+        rows[n - 1] = rightSmoothRow(knot(n - 1), knot(n), bAsymmetric);
+        solveTridiagonal(&rows[0], n);
 
         // Now update the segments
-        for (Int64 i = paddingLeft, max = n - paddingRight, j = _from; i <= max; i++, j++)
+        for (Int64 i = paddingLeft, max = n - paddingRight, j = from; i <= max; i++, j++)
         {
-            Int64 index = j < 0 ? j + m_segmentData.count() : j;
-            SegmentData & segment = m_segmentData[index];
-            Float hx = px[i] - segment.position.x;
-            Float hy = py[i] - segment.position.y;
+            Int64 index = j < 0 ? j + count : j;
+            SegmentData & segment = _segments[index];
+            Vec2f p = i < n ? rows[i].d : (knot(n) * 3 - rows[n - 1].d) / 2;
+            Vec2f h = p - segment.position;
             if (bLoop || i < max)
             {
-                segment.handleOut = segment.position + Vec2f(hx, hy);
+                segment.handleOut = segment.position + h;
             }
             if (bLoop || i > paddingLeft)
             {
-                segment.handleIn = segment.position - Vec2f(hx, hy);
+                segment.handleIn = segment.position - h;
             }
         }
 
+        return true;
+    }
+    return false;
+}
+
+bool smoothAround(SegmentData * _segments,
+                  Size _count,
+                  bool _bClosed,
+                  Int64 _from,
+                  Int64 _to,
+                  Smoothing _type,
+                  Size _padding,
+                  Int64 * _outFirst,
+                  Int64 * _outLast)
+{
+    if (_type != Smoothing::Asymmetric && _type != Smoothing::Continuous)
+        return false;
+
+    Int64 count = _count;
+    Int64 from = smoothIndex(_from, count, _bClosed);
+    Int64 to = smoothIndex(_to, count, _bClosed);
+    if (from > to)
+    {
+        if (_bClosed)
+            from -= count;
+        else
+            std::swap(from, to);
+    }
+
+    // the unknowns are the first control points p[i] of the curves, which are the handle outs
+    // of the segments. The window is bounded by two segments whose handles are kept.
+    Int64 lo = from - (Int64)_padding;
+    Int64 hi = to + (Int64)_padding;
+    // if the window reaches the end of an open path, the same end conditions as in smooth apply
+    bool bNaturalLeft = !_bClosed && lo <= 0;
+    bool bNaturalRight = !_bClosed && hi >= count - 2;
+    if (bNaturalLeft)
+        lo = 0;
+    if (bNaturalRight)
+        hi = count - 1;
+
+    // the window covers the whole path
+    if (_bClosed ? hi - lo + 1 >= count : bNaturalLeft && bNaturalRight)
+    {
+        if (!smooth(_segments, _count, _bClosed, 0, count - 1, _type))
+            return false;
+        *_outFirst = 0;
+        *_outLast = count - 1;
+        return true;
+    }
+
+    auto segment = [&](Int64 _i) -> SegmentData & {
+        return _segments[((_i % count) + count) % count];
+    };
+
+    Int64 first = bNaturalLeft ? lo : lo + 1;
+    Int64 last = hi - 1;
+    Int64 n = last - first + 1;
+    if (n < 1)
+        return false;
+
+    detail::ScratchScope scratch;
+    DynamicArray<TridiagonalRow> rows(scratch.allocator());
+    rows.resize(n);
+    for (Int64 i = first; i <= last; i++)
+    {
+        const Vec2f & k0 = segment(i).position;
+        const Vec2f & k1 = segment(i + 1).position;
+        TridiagonalRow & row = rows[i - first];
+        if (bNaturalLeft && i == 0)
+            row = leftSmoothRow(k0, k1);
+        else if (bNaturalRight && i == count - 2)
+            row = rightSmoothRow(k0, k1, _type == Smoothing::Asymmetric);
+        else
+            row = internalSmoothRow(k0, k1);
+    }
+    if (!bNaturalLeft)
+    {
+        rows[0].d -= segment(lo).handleOut * rows[0].a;
+        rows[0].a = 0;
+    }
+    if (!bNaturalRight)
+    {
+        rows[n - 1].d -= segment(hi).handleOut * rows[n - 1].c;
+        rows[n - 1].c = 0;
+    }
+    solveTridiagonal(&rows[0], n);
+
+    for (Int64 i = first; i <= last; i++)
+    {
+        SegmentData & seg = segment(i);
+        Vec2f h = rows[i - first].d - seg.position;
+        seg.handleOut = seg.position + h;
+        if (i > 0 || _bClosed)
+            seg.handleIn = seg.position - h;
+    }
+    if (bNaturalRight)
+    {
+        SegmentData & seg = segment(count - 1);
+        seg.handleIn = seg.position - ((seg.position * 3 - rows[n - 1].d) / 2 - seg.position);
+    }
+
+    *_outFirst = first;
+    *_outLast = bNaturalRight ? count - 1 : last;
+    return true;
+}
+} // namespace segments
+
+void Path::smooth(Int64 _from, Int64 _to, Smoothing _type)
+{
+    if (m_segmentData.count() &&
+        segments::smooth(
+            &m_segmentData[0], m_segmentData.count(), isClosed(), _from, _to, _type))
+    {
         rebuildCurves();
         markGeometryDirty(true);
     }
 }
 
+void Path::smoothAround(Int64 _from, Int64 _to, Smoothing _type, Size _padding)
+{
+    Int64 first, last;
+    if (!m_segmentData.count() || !segments::smoothAround(&m_segmentData[0],
+                                                          m_segmentData.count(),
+                                                          isClosed(),
+                                                          _from,
+                                                          _to,
+                                                          _type,
+                                                          _padding,
+                                                          &first,
+                                                          &last))
+        return;
+
+    // only the curves touching the changed segments need to be rebuilt
+    Int64 curveCount = m_curveData.count();
+    if (last - first + 2 >= curveCount)
+    {
+        rebuildCurves();
+    }
+    else
+    {
+        for (Int64 i = first - 1; i <= last; i++)
+        {
+            Int64 idx = ((i % curveCount) + curveCount) % curveCount;
+            if (isClosed() || (i >= 0 && i < curveCount))
+                m_curveData[idx] = CurveData{};
+        }
+    }
+    markGeometryDirty(true);
+}
+
 void Path::simplify(Float _tolerance)
+{
+    SegmentDataArray segs(m_segmentData.allocator());
+    if (simplifiedSegments(_tolerance, segs))
+        swapSegments(segs, isClosed());
+}
+
+bool Path::simplifiedSegments(Float _tolerance, SegmentDataArray & _outSegments) const
 {
     detail::PathFitter fitter(this, _tolerance, false);
-    fitter.fit();
+    return fitter.fit(_outSegments);
+}
+
+bool Path::smoothedSegments(Smoothing _type, SegmentDataArray & _outSegments) const
+{
+    if (!m_segmentData.count())
+        return false;
+
+    _outSegments = m_segmentData;
+    return segments::smooth(&_outSegments[0],
+                            _outSegments.count(),
+                            isClosed(),
+                            0,
+                            m_segmentData.count() - 1,
+                            _type);
 }
 
 void Path::addSegment(const Vec2f & _point, const Vec2f & _handleIn, const Vec2f & _handleOut)
@@ -1059,16 +1339,29 @@ void Path::insertSegments(Size _index, const SegmentData * _segments, Size _coun
         }
     }
     // insert case
-    else
+    else if (m_curveData.count())
     {
         m_segmentData.insert(m_segmentData.begin() + _index, _segments, _segments + _count);
 
-        // insert new curves and reset all affected ones
-        //@TODO: technically we should be able to use an end index, too no?
-        m_curveData.resize(m_curveData.count() + _count);
-        auto cit = m_curveData.begin() + _index;
-        for (; cit != m_curveData.end(); ++cit)
-            *cit = CurveData{};
+        // the new segments split the curve that used to end at _index, all other curves keep
+        // their segments and only move back. Curve _index - 1 and the _count new curves after it
+        // are the ones that need to be recomputed.
+        Size oldCount = m_curveData.count();
+        m_curveData.resize(oldCount + _count);
+        std::move_backward(m_curveData.begin() + _index,
+                           m_curveData.begin() + oldCount,
+                           m_curveData.end());
+        std::fill(m_curveData.begin() + _index, m_curveData.begin() + _index + _count, CurveData{});
+        if (_index > 0)
+            m_curveData[_index - 1] = CurveData{};
+        else if (isClosed())
+            m_curveData.last() = CurveData{};
+    }
+    else
+    {
+        // there were no curves before, i.e. less than two segments
+        m_segmentData.insert(m_segmentData.begin() + _index, _segments, _segments + _count);
+        rebuildCurves();
     }
 
     markGeometryDirty(true);
@@ -1087,10 +1380,34 @@ void Path::removeSegments(Size _from)
 void Path::removeSegments(Size _from, Size _to)
 {
     STICK_ASSERT(_from < m_segmentData.count());
-    STICK_ASSERT(_to < m_segmentData.count());
+    STICK_ASSERT(_to <= m_segmentData.count());
+    if (_from >= _to)
+        return;
+
+    bool bRemovesEnd = _to == m_segmentData.count();
     m_segmentData.remove(m_segmentData.begin() + _from, m_segmentData.begin() + _to);
-    //@TODO: Instead of rebuilding all curves only update the ones directly affected?
-    rebuildCurves();
+
+    if (m_segmentData.count() < 2)
+    {
+        rebuildCurves();
+    }
+    else if (!isClosed() && bRemovesEnd)
+    {
+        // removing the end of an open path also removes the curve leading to it
+        m_curveData.resize(m_segmentData.count() - 1);
+    }
+    else
+    {
+        // the curves starting at the removed segments are gone, the curve in front of them
+        // now ends at the segment that followed the removed range. All other curves are
+        // untouched and keep their cached data.
+        m_curveData.remove(m_curveData.begin() + _from, m_curveData.begin() + _to);
+        if (_from > 0)
+            m_curveData[_from - 1] = CurveData{};
+        else if (isClosed())
+            m_curveData.last() = CurveData{};
+    }
+
     markGeometryDirty(true);
 }
 
@@ -1146,15 +1463,8 @@ void Path::flatten(Float _angleTolerance,
                    Float _minDistance,
                    Size _maxRecursion)
 {
-    detail::PathFlattener::PositionArray newSegmentPositions(m_segmentData.allocator());
-    newSegmentPositions.reserve(1024);
-    detail::PathFlattener::flatten(
-        this, newSegmentPositions, nullptr, _angleTolerance, _minDistance, _maxRecursion);
-
-    SegmentDataArray segs(newSegmentPositions.count(), m_segmentData.allocator());
-    for (Size i = 0; i < newSegmentPositions.count(); ++i)
-        segs[i] = SegmentData{ Vec2f(0), newSegmentPositions[i], Vec2f(0) };
-
+    SegmentDataArray segs(m_segmentData.allocator());
+    flattenedSegments(_angleTolerance, _minDistance, _maxRecursion, segs);
     swapSegments(segs, isClosed());
 
     if (_bFlattenChildren)
@@ -1164,6 +1474,377 @@ void Path::flatten(Float _angleTolerance,
     }
 }
 
+bool Path::flattenedSegments(Float _angleTolerance,
+                             Float _minDistance,
+                             Size _maxRecursion,
+                             SegmentDataArray & _outSegments) const
+{
+    auto toSegments = [&_outSegments](const DynamicArray<Vec2f> & _positions) {
+        _outSegments.resize(_positions.count());
+        for (Size i = 0; i < _positions.count(); ++i)
+            _outSegments[i] = SegmentData{ _positions[i], _positions[i], _positions[i] };
+    };
+
+    // only reuse the cache if somebody asked for it, the segments usually replace the geometry
+    // which would drop a cache filled here right away.
+    if (hasFlattenedPositions(_angleTolerance, _minDistance, _maxRecursion))
+    {
+        toSegments(m_flattened);
+        return true;
+    }
+
+    detail::ScratchScope scratch;
+    DynamicArray<Vec2f> positions(scratch.allocator());
+    detail::PathFlattener::flatten(
+        this, positions, nullptr, _angleTolerance, _minDistance, _maxRecursion);
+    toSegments(positions);
+    return true;
+}
+
+bool Path::hasFlattenedPositions(Float _angleTolerance, Float _minDistance, Size _maxRecursion) const
+{
+    return m_flattened.count() && m_flatteningSettings.angleTolerance == _angleTolerance &&
+           m_flatteningSettings.minDistance == _minDistance &&
+           m_flatteningSettings.maxRecursion == _maxRecursion;
+}
+
+const DynamicArray<Vec2f> & Path::flattenedPositions(Float _angleTolerance,
+                                                     Float _minDistance,
+                                                     Size _maxRecursion) const
+{
+    if (hasFlattenedPositions(_angleTolerance, _minDistance, _maxRecursion))
+        return m_flattened;
+
+    m_flattened.clear();
+    detail::PathFlattener::flatten(
+        this, m_flattened, nullptr, _angleTolerance, _minDistance, _maxRecursion);
+    m_flatteningSettings = { _angleTolerance, _minDistance, _maxRecursion };
+    return m_flattened;
+}
+
+static void addStrokeOutline(const Path * _path,
+                             const Mat32f & _transform,
+                             bool _bTransformed,
+                             detail::StrokeOutliner & _outliner,
+                             DynamicArray<Vec2f> & _tmp)
+{
+    const auto & positions = _path->flattenedPositions();
+    if (!positions.count() && _path->segmentCount() == 1)
+    {
+        // a single segment has no curves to flatten, but its caps are still drawn
+        Vec2f p = _bTransformed ? _transform * _path->segmentData()[0].position
+                                : _path->segmentData()[0].position;
+        _outliner.addPolyline(&p, 1, false);
+    }
+    else if (positions.count())
+    {
+        if (_bTransformed)
+        {
+            _tmp.resize(positions.count());
+            for (Size i = 0; i < positions.count(); ++i)
+                _tmp[i] = _transform * positions[i];
+            _outliner.addPolyline(&_tmp[0], _tmp.count(), _path->isClosed());
+        }
+        else
+            _outliner.addPolyline(&positions[0], positions.count(), _path->isClosed());
+    }
+
+    for (Item * c : _path->children())
+    {
+        if (c->hasTransform())
+            addStrokeOutline(
+                static_cast<Path *>(c), _transform * c->transform(), true, _outliner, _tmp);
+        else
+            addStrokeOutline(static_cast<Path *>(c), _transform, _bTransformed, _outliner, _tmp);
+    }
+}
+
+const PolygonArray & Path::strokeOutlineLocal() const
+{
+    // non scaling strokes have their width in document space, so their outline is built there
+    // and moved back to item space afterwards.
+    bool bStrokeTransformed = !scaleStroke() && isTransformed();
+    Mat32f strokeTransform = bStrokeTransformed ? absoluteTransform() : Mat32f::identity();
+
+    const StrokeOutlineSettings & s = m_strokeOutlineSettings;
+    if (!m_bStrokeOutlineDirty && s.strokeWidth == strokeWidth() &&
+        s.strokeJoin == strokeJoin() && s.strokeCap == strokeCap() &&
+        s.miterLimit == miterLimit() && s.dashOffset == dashOffset() &&
+        s.strokeTransform == strokeTransform && s.dashArray.count() == dashArray().count() &&
+        std::equal(s.dashArray.begin(), s.dashArray.end(), dashArray().begin()))
+        return m_strokeOutline;
+
+    m_strokeOutline.clear();
+    m_strokeOutlineSettings = { strokeWidth(), strokeJoin(), strokeCap(), miterLimit(),
+                                dashArray(),   dashOffset(), strokeTransform };
+    m_bStrokeOutlineDirty = false;
+
+    const Mat32f & m = strokeTransform;
+    if (m[0].x * m[1].y - m[1].x * m[0].y == 0)
+        return m_strokeOutline;
+
+    detail::StrokeOutliner outliner(strokeWidth(),
+                                    strokeJoin(),
+                                    strokeCap(),
+                                    miterLimit(),
+                                    dashArray(),
+                                    dashOffset(),
+                                    m_strokeOutline);
+    DynamicArray<Vec2f> tmp(m_strokeOutline.allocator());
+    addStrokeOutline(this, strokeTransform, bStrokeTransformed, outliner, tmp);
+
+    if (bStrokeTransformed)
+    {
+        Mat32f inv = crunch::inverse(strokeTransform);
+        for (auto & poly : m_strokeOutline)
+            for (auto & p : poly)
+                p = inv * p;
+    }
+
+    return m_strokeOutline;
+}
+
+Path * Path::strokeOutline() const
+{
+    const PolygonArray & polygons = strokeOutlineLocal();
+
+    Path * ret = m_document->createPath();
+    ret->setStyle(stylePtr());
+    ret->setFill(stroke());
+    ret->removeStroke();
+    ret->setWindingRule(WindingRule::NonZero);
+    ret->setTransform(transform());
+    ret->insertAbove(this);
+
+    for (Size i = 0; i < polygons.count(); ++i)
+    {
+        SegmentDataArray segs(m_document->allocator());
+        segs.reserve(polygons[i].count());
+        for (const Vec2f & p : polygons[i])
+            segs.append({ p, p, p });
+
+        if (i == 0)
+            ret->swapSegments(segs, true);
+        else
+        {
+            Path * child = m_document->createPath();
+            child->swapSegments(segs, true);
+            ret->addChild(child);
+        }
+    }
+
+    return ret;
+}
+
+// regular parameter steps per curve in the arc length table
+static const Size s_arcLengthSteps = 16;
+
+Path * Path::dashed() const
+{
+    return dashed(dashArray(), dashOffset());
+}
+
+Path * Path::dashed(const DashArray & _dashArray, Float _dashOffset) const
+{
+    Path * ret = m_document->createPath();
+    ret->setStyle(stylePtr());
+    ret->removeFill();
+    ret->setDashArray(DashArray());
+    ret->setTransform(transform());
+    ret->insertAbove(this);
+
+    detail::DashPattern pattern(_dashArray, _dashOffset);
+    addDashes(pattern, nullptr, ret);
+
+    return ret;
+}
+
+// length of the derivative of _bez at _t
+static Float speedAt(const Bezier & _bez, Float _t)
+{
+    Float u = 1 - _t;
+    Vec2f d = (_bez.handleOne() - _bez.positionOne()) * (u * u) +
+              (_bez.handleTwo() - _bez.handleOne()) * (2 * u * _t) +
+              (_bez.positionTwo() - _bez.handleTwo()) * (_t * _t);
+    return 3 * crunch::length(d);
+}
+
+// simpson's rule, accurate enough for the short spans between arc length table entries
+static Float spanLength(const Bezier & _bez, Float _from, Float _to)
+{
+    return (_to - _from) / 6 *
+           (speedAt(_bez, _from) + 4 * speedAt(_bez, (_from + _to) * 0.5f) + speedAt(_bez, _to));
+}
+
+// fills the s_arcLengthSteps table entries of a curve that starts at _offset. The spans are
+// scaled to match _length exactly, so consecutive curves line up.
+static void curveArcLengths(const Bezier & _bez, Float _offset, Float _length, Float * _out)
+{
+    Float lengths[s_arcLengthSteps];
+    Float sum = 0;
+    for (Size j = 0; j < s_arcLengthSteps; ++j)
+    {
+        sum += spanLength(_bez, (Float)j / s_arcLengthSteps, (Float)(j + 1) / s_arcLengthSteps);
+        lengths[j] = sum;
+    }
+
+    Float scale = sum > 0 ? _length / sum : 0.0f;
+    _out[0] = _offset;
+    for (Size j = 1; j < s_arcLengthSteps; ++j)
+        _out[j] = _offset + lengths[j - 1] * scale;
+}
+
+// finds the curve and parameter at _offset in the arc length table. _step is the table index to
+// start searching from, the offsets need to be increasing from call to call. Dash starts are
+// placed on the next curve if they fall onto the end of one, dash ends on the previous one.
+static void arcLengthParameter(const Bezier * _curves,
+                               const DynamicArray<Float> & _arcLengths,
+                               Size & _step,
+                               Float _offset,
+                               bool _bStart,
+                               Size & _outCurve,
+                               Float & _outParameter)
+{
+    while (_step + 2 < _arcLengths.count() &&
+           (_bStart ? _arcLengths[_step + 1] <= _offset : _arcLengths[_step + 1] < _offset))
+        ++_step;
+
+    _outCurve = _step / s_arcLengthSteps;
+    Float from = (Float)(_step % s_arcLengthSteps) / s_arcLengthSteps;
+    Float to = from + 1.0f / s_arcLengthSteps;
+
+    // interpolate linearly in the table and refine with a few newton steps on the curve
+    Float span = _arcLengths[_step + 1] - _arcLengths[_step];
+    if (span <= 0)
+    {
+        _outParameter = from;
+        return;
+    }
+    Float f = std::min(std::max((_offset - _arcLengths[_step]) / span, 0.0f), 1.0f);
+    Float t = from + (to - from) * f;
+
+    const Bezier & bez = _curves[_outCurve];
+    for (Size i = 0; i < 2; ++i)
+    {
+        Float speed = speedAt(bez, t);
+        if (speed <= detail::PaperConstants::epsilon())
+            break;
+        t -= (_arcLengths[_step] + spanLength(bez, from, t) - _offset) / speed;
+        t = std::min(std::max(t, from), to);
+    }
+    _outParameter = t;
+}
+
+static void addDash(Path * _target, SegmentDataArray & _segments, bool _bClosed)
+{
+    if (!_target->segmentData().count() && !_target->children().count())
+        _target->swapSegments(_segments, _bClosed);
+    else
+    {
+        Path * child = _target->document()->createPath();
+        child->setStyle(_target->stylePtr());
+        child->swapSegments(_segments, _bClosed);
+        _target->addChild(child);
+    }
+}
+
+void Path::addDashes(detail::DashPattern & _pattern,
+                     const Mat32f * _transform,
+                     Path * _target) const
+{
+    if (!_pattern.isValid())
+    {
+        if (m_segmentData.count())
+        {
+            SegmentDataArray segs(m_document->allocator());
+            segs.resize(m_segmentData.count());
+            if (_transform)
+                segments::transform(*_transform, &m_segmentData[0], &segs[0], segs.count());
+            else
+                std::copy(m_segmentData.begin(), m_segmentData.end(), segs.begin());
+            addDash(_target, segs, isClosed());
+        }
+    }
+    else if (m_curveData.count())
+    {
+        // transformed children are measured in the space they are dashed in, just like the
+        // stroke outline does. Otherwise a scaled child would get scaled dashes.
+        detail::ScratchScope scratch;
+        DynamicArray<Bezier> curves(scratch.allocator());
+        DynamicArray<Float> transformedTable(scratch.allocator());
+        curves.resize(m_curveData.count());
+        for (Size i = 0; i < curves.count(); ++i)
+            curves[i] = _transform ? curve(i).transformedBezier(*_transform) : curve(i).bezier();
+
+        if (_transform)
+        {
+            transformedTable.resize(curves.count() * s_arcLengthSteps + 1);
+            Float offset = 0;
+            for (Size i = 0; i < curves.count(); ++i)
+            {
+                Float curveLength = curves[i].length();
+                curveArcLengths(
+                    curves[i], offset, curveLength, &transformedTable[i * s_arcLengthSteps]);
+                offset += curveLength;
+            }
+            transformedTable.last() = offset;
+        }
+
+        const auto & table = _transform ? transformedTable : arcLengths();
+        Float len = table.last();
+        Float pos = 0;
+        Size step = 0;
+        _pattern.start();
+        while (true)
+        {
+            Float end = std::min(pos + _pattern.remaining(), len);
+            if (_pattern.isOn())
+            {
+                Size c0, c1;
+                Float t0, t1;
+                arcLengthParameter(&curves[0], table, step, pos, true, c0, t0);
+                Size endStep = step;
+                arcLengthParameter(&curves[0], table, endStep, end, false, c1, t1);
+
+                // consecutive beziers share a segment, the first and last one are sliced
+                SegmentDataArray segs(m_document->allocator());
+                segs.reserve(c1 - c0 + 2);
+                for (Size i = c0; i <= c1; ++i)
+                {
+                    Float a = i == c0 ? t0 : 0.0f;
+                    Float b = i == c1 ? t1 : 1.0f;
+                    Bezier bez = a == 0 && b == 1 ? curves[i] : curves[i].slice(a, b);
+                    if (!segs.count())
+                        segs.append({ bez.positionOne(), bez.positionOne(), bez.handleOne() });
+                    else
+                        segs.last().handleOut = bez.handleOne();
+                    segs.append({ bez.handleTwo(), bez.positionTwo(), bez.positionTwo() });
+                }
+
+                addDash(_target, segs, false);
+                step = endStep;
+            }
+
+            if (pos + _pattern.remaining() >= len)
+                break;
+            pos += _pattern.remaining();
+            _pattern.next();
+        }
+    }
+
+    Mat32f tmp;
+    for (Item * c : children())
+    {
+        const Mat32f * transform = _transform;
+        if (c->hasTransform())
+        {
+            tmp = _transform ? *_transform * c->transform() : c->transform();
+            transform = &tmp;
+        }
+        static_cast<const Path *>(c)->addDashes(_pattern, transform, _target);
+    }
+}
+
 void Path::flattenRegular(Float _maxDistance, bool _bFlattenChildren)
 {
     SegmentDataArray segs(m_segmentData.allocator());
@@ -1184,16 +1865,25 @@ void Path::flattenRegular(Float _maxDistance, bool _bFlattenChildren)
     Float len = length();
     Float off = 0;
     Vec2f pos;
+
+    // the offsets only grow, so we walk the curves alongside them instead of looking up the
+    // curve for every offset.
+    const auto & offsets = curveOffsets();
+    Size curveIndex = 0;
     while (off < len)
     {
-        pos = positionAt(std::min(off, len));
+        while (curveIndex + 2 < offsets.count() && offsets[curveIndex + 1] < off)
+            ++curveIndex;
+        pos = curve(curveIndex).positionAt(off - offsets[curveIndex]);
         segs.append({ pos, pos, pos });
         off += _maxDistance;
     }
 
-    if (off - len > 0)
+    // the samples stop short of the end, which open paths still need to keep. On closed paths
+    // the end is the first sample again.
+    if (!isClosed() && m_segmentData.count())
     {
-        pos = positionAt(len);
+        pos = m_segmentData.last().position;
         segs.append({ pos, pos, pos });
     }
 
@@ -1246,13 +1936,9 @@ const SegmentDataArray & Path::segmentData() const
 
 SegmentDataArray Path::segmentData(const Mat32f & _transform) const
 {
-    SegmentDataArray ret = m_segmentData;
-    for (auto & seg : ret)
-    {
-        seg.handleIn = _transform * seg.handleIn;
-        seg.position = _transform * seg.position;
-        seg.handleOut = _transform * seg.handleOut;
-    }
+    SegmentDataArray ret(m_segmentData.count(), m_segmentData.allocator());
+    if (m_segmentData.count())
+        segments::transform(_transform, &m_segmentData[0], &ret[0], m_segmentData.count());
     return ret;
 }
 
@@ -1382,23 +2068,13 @@ static CurveLocation closestCurveLocationImpl(const Path * _path,
     Float currentParameter;
     CurveLocation ret;
 
-    const SegmentDataArray * segments;
-    SegmentDataArray tmp;
-    if (_transform)
-    {
-        tmp = _path->segmentData(*_transform);
-        segments = &tmp;
-    }
-    else
-        segments = &_path->segmentData();
+    // transform the curves one by one rather than copying all segments to a temporary array.
+    detail::TransformedSegmentView segments(_path, _transform);
 
     Bezier bez, closestBez;
-    for (Size i = 0; i < (_path->isClosed() ? segments->count() : segments->count() - 1); ++i)
+    for (Size i = 0; i < segments.curveCount(); ++i)
     {
-        bez = Bezier((*segments)[i].position,
-                     (*segments)[i].handleOut,
-                     (*segments)[(i + 1) % (*segments).count()].handleIn,
-                     (*segments)[(i + 1) % (*segments).count()].position);
+        bez = segments.curveBezier(i);
 
         currentParameter = bez.closestParameter(_point, currentDist, 0, 1, 0);
         if (currentDist < _outDistance)
@@ -1500,6 +2176,12 @@ Vec2f Path::closestPoint(const Vec2f & _point,
                          Float & _outDistance) const
 {
     Vec2f ret;
+    detail::Shape shape;
+    if (analyticShape(&_transform, shape) && shape.closestPoint(_point, ret))
+    {
+        _outDistance = crunch::distance(_point, ret);
+        return ret;
+    }
     closestCurveLocationImpl(this, _point, _outDistance, &ret, &_transform);
     return ret;
 }
@@ -1512,6 +2194,13 @@ Vec2f Path::closestPoint(const Vec2f & _point, const Mat32f & _transform) const
 
 Vec2f Path::closestPointLocal(const Vec2f & _point, Float & _outDistance) const
 {
+    Vec2f ret;
+    detail::Shape shape;
+    if (analyticShape(nullptr, shape) && shape.closestPoint(_point, ret))
+    {
+        _outDistance = crunch::distance(_point, ret);
+        return ret;
+    }
     return closestCurveLocation(_point, _outDistance).position();
 }
 
@@ -1523,22 +2212,16 @@ Vec2f Path::closestPointLocal(const Vec2f & _point) const
 
 CurveLocation Path::curveLocationAt(Float _offset) const
 {
-    Float len = 0;
-    Float start;
-
-    auto cv = curves();
-    auto it = cv.begin();
+    const auto & offsets = curveOffsets();
+    if (!offsets.count())
+        return CurveLocation();
 
-    for (; it != cv.end(); ++it)
+    // binary search for the first curve that ends at or after the offset
+    auto it = std::lower_bound(offsets.begin() + 1, offsets.end(), _offset);
+    if (it != offsets.end())
     {
-        start = len;
-        len += (*it).length();
-
-        // we found the curve
-        if (len >= _offset)
-        {
-            return (*it).curveLocationAt(_offset - start);
-        }
+        Size index = it - offsets.begin() - 1;
+        return ConstCurve(this, index).curveLocationAt(_offset - offsets[index]);
     }
 
     // comment from paper.js source in Path.js:
@@ -1552,19 +2235,88 @@ CurveLocation Path::curveLocationAt(Float _offset) const
     return CurveLocation();
 }
 
+void Path::sampleAt(const Float * _offsets,
+                    Size _count,
+                    Vec2f * _outPositions,
+                    Vec2f * _outTangents,
+                    Vec2f * _outNormals) const
+{
+    const auto & offsets = curveOffsets();
+    if (!offsets.count())
+        return;
+
+    Size curveIndex = 0;
+    Float prev = 0;
+    for (Size i = 0; i < _count; ++i)
+    {
+        Float off = _offsets[i];
+        if (off < prev)
+        {
+            // not sorted, search from the start
+            auto it = std::lower_bound(offsets.begin() + 1, offsets.end() - 1, off);
+            curveIndex = it - offsets.begin() - 1;
+        }
+        else
+        {
+            while (curveIndex + 2 < offsets.count() && offsets[curveIndex + 1] < off)
+                ++curveIndex;
+        }
+        prev = off;
+
+        const Bezier & bez = curve(curveIndex).bezier();
+        Float t = bez.parameterAtOffset(off - offsets[curveIndex]);
+        if (_outPositions)
+            _outPositions[i] = bez.positionAt(t);
+        if (_outTangents)
+            _outTangents[i] = bez.tangentAt(t);
+        if (_outNormals)
+            _outNormals[i] = bez.normalAt(t);
+    }
+}
+
 Float Path::length() const
 {
+    // always from the offsets, so positionAt(length()) is the end of the path
     if (!m_length)
     {
+        const auto & offsets = curveOffsets();
+        m_length = offsets.count() ? offsets.last() : 0.0f;
+    }
+    return *m_length;
+}
+
+const stick::DynamicArray<Float> & Path::arcLengths() const
+{
+    if (!m_arcLengths.count() && m_curveData.count())
+    {
+        const auto & offsets = curveOffsets();
+        m_arcLengths.resize(m_curveData.count() * s_arcLengthSteps + 1);
+        for (Size i = 0; i < m_curveData.count(); ++i)
+        {
+            curveArcLengths(curve(i).bezier(),
+                            offsets[i],
+                            offsets[i + 1] - offsets[i],
+                            &m_arcLengths[i * s_arcLengthSteps]);
+        }
+        m_arcLengths.last() = offsets.last();
+    }
+    return m_arcLengths;
+}
+
+const stick::DynamicArray<Float> & Path::curveOffsets() const
+{
+    if (!m_curveOffsets.count() && m_curveData.count())
+    {
+        m_curveOffsets.reserve(m_curveData.count() + 1);
         Float len = 0.0f;
+        m_curveOffsets.append(len);
         for (Size i = 0; i < m_curveData.count(); ++i)
         {
-            ConstCurve c = curve(i);
-            len += c.length();
+            len += curve(i).length();
+            m_curveOffsets.append(len);
         }
-        m_length = len;
     }
-    return *m_length;
+    return m_curveOffsets;
 }
 
 void Path::peaks(stick::DynamicArray<CurveLocation> & _peaks) const
@@ -1598,22 +2350,80 @@ stick::DynamicArray<CurveLocation> Path::extrema() const
 
 Float Path::area() const
 {
-    Float ret = 0;
-    for (ConstCurve c : curves())
-    {
-        ret += c.area();
-    }
+    detail::Shape shape;
+    if (analyticShape(nullptr, shape))
+        return shape.area();
+
+    if (!m_children.count())
+        return contourMoments().area;
+    return moments().area;
+}
+
+// the moments of the area after moving it by _transform. Integrating over the transformed area
+// scales everything by the determinant, which also flips the sign for mirroring transforms.
+static Moments transformMoments(const Moments & _m, const Mat32f & _transform)
+{
+    Float a = _transform[0].x;
+    Float b = _transform[0].y;
+    Float c = _transform[1].x;
+    Float d = _transform[1].y;
+    Float tx = _transform[2].x;
+    Float ty = _transform[2].y;
+    Float det = a * d - c * b;
+    const Vec2f & f = _m.first;
+    const Vec2f & s = _m.second;
+
+    Moments ret;
+    ret.area = det * _m.area;
+    ret.first = Vec2f(a * f.x + c * f.y + tx * _m.area, b * f.x + d * f.y + ty * _m.area) * det;
+    ret.second = Vec2f(a * a * s.x + c * c * s.y + 2 * a * c * _m.product +
+                           2 * tx * (a * f.x + c * f.y) + tx * tx * _m.area,
+                       b * b * s.x + d * d * s.y + 2 * b * d * _m.product +
+                           2 * ty * (b * f.x + d * f.y) + ty * ty * _m.area) *
+                 det;
+    ret.product = (a * b * s.x + c * d * s.y + (a * d + b * c) * _m.product +
+                   (a * ty + b * tx) * f.x + (c * ty + d * tx) * f.y + tx * ty * _m.area) *
+                  det;
+    return ret;
+}
+
+Moments Path::moments() const
+{
+    Moments ret = contourMoments();
 
-    // take children into account
+    // children are in the space of this path after applying their transform
     for (Item * c : this->children())
     {
-        if (c->itemType() == ItemType::Path)
-            ret += static_cast<Path *>(c)->area();
+        if (c->itemType() != ItemType::Path)
+            continue;
+        Moments m = static_cast<Path *>(c)->moments();
+        if (c->hasTransform())
+            m = transformMoments(m, c->transform());
+        ret.area += m.area;
+        ret.first += m.first;
+        ret.second += m.second;
+        ret.product += m.product;
     }
-
     return ret;
 }
 
+Vec2f Path::centroid() const
+{
+    Moments m = moments();
+    return m.area != 0 ? m.first / m.area : Vec2f(0);
+}
+
+const Moments & Path::contourMoments() const
+{
+    if (!m_moments)
+    {
+        m_moments = m_segmentData.count()
+                        ? segments::moments(&m_segmentData[0], m_segmentData.count(), isClosed())
+                        : Moments{ 0, Vec2f(0), Vec2f(0), 0 };
+    }
+    return *m_moments;
+}
+
 bool Path::isClosed() const
 {
     return m_bIsClosed;
@@ -1639,7 +2449,8 @@ bool Path::isClockwise() const
 void Path::rebuildCurves()
 {
     m_curveData.clear();
-    m_curveData.resize(m_segmentData.count() - 1, CurveData{});
+    if (m_segmentData.count() > 1)
+        m_curveData.resize(m_segmentData.count() - 1, CurveData{});
     if (isClosed())
     {
         m_bIsClosed = false;
@@ -1785,29 +2596,38 @@ static void mergeStrokeJoin(Rect & _rect,
 
 bool Path::containsImpl(const Vec2f & _point, const Mat32f * _transform) const
 {
-    // only use early out if no transform is provided (and we thus are on item space)
-    if (!_transform && !handleBounds().contains(_point))
-        return false;
-
-    const detail::MonoCurveLoopArray * loopArray;
-    detail::MonoCurveLoopArray tmp(document()->allocator());
-    if (!_transform)
-    {
-        if (m_monoCurves.count() == 0)
-            detail::BooleanOperations::monoCurves(
-                this, m_monoCurves, isTransformed() ? &absoluteTransform() : nullptr);
-        loopArray = &m_monoCurves;
-    }
-    else
+    // the mono curves are cached in item space, so we move the point there instead of
+    // transforming the curves.
+    Vec2f localPoint = _point;
+    const Mat32f * transform = _transform ? _transform : isTransformed() ? &absoluteTransform() : nullptr;
+    if (transform)
     {
-        detail::BooleanOperations::monoCurves(this, tmp, _transform);
-        loopArray = &tmp;
+        const Mat32f & m = *transform;
+        if (m[0].x * m[1].y - m[1].x * m[0].y == 0)
+        {
+            // degenerate transform, there is no item space point to test
+            detail::MonoCurveLoopArray tmp(document()->allocator());
+            detail::BooleanOperations::monoCurves(this, tmp, transform);
+            Int32 winding = detail::BooleanOperations::winding(_point, tmp, false);
+            return windingRule() == WindingRule::EvenOdd ? winding & 1 : winding > 0;
+        }
+        localPoint = crunch::inverse(m) * _point;
     }
 
+    detail::Shape shape;
+    if (analyticShape(nullptr, shape))
+        return shape.contains(localPoint);
+
+    // handleBounds are in document space for transformed paths
+    const Maybe<Rect> & bounds = cachedMonoCurveBounds();
+    if (!bounds || !bounds->contains(localPoint))
+        return false;
+
+    Int32 winding = detail::BooleanOperations::winding(localPoint, cachedMonoCurves(), false);
     if (windingRule() == WindingRule::EvenOdd)
-        return detail::BooleanOperations::winding(_point, *loopArray, false) & 1;
+        return winding & 1;
     else
-        return detail::BooleanOperations::winding(_point, *loopArray, false) > 0;
+        return winding > 0;
 }
 
 bool Path::contains(const Vec2f & _point) const
@@ -1820,6 +2640,165 @@ bool Path::contains(const Vec2f & _point, const Mat32f & _transform) const
     return containsImpl(_point, &_transform);
 }
 
+bool Path::strokeContainsImpl(const Vec2f & _point, const Mat32f * _transform) const
+{
+    // the stroke bounds are padded generously and usually cached already, so they reject most
+    // points before the outline is even looked at. Without a stroke paint they don't include
+    // the stroke though.
+    if (!_transform && !stroke().is<NoPaint>() && !strokeBounds().contains(_point))
+        return false;
+
+    Vec2f localPoint = _point;
+    const Mat32f * transform =
+        _transform ? _transform : isTransformed() ? &absoluteTransform() : nullptr;
+    if (transform)
+    {
+        const Mat32f & m = *transform;
+        // degenerate transform, the stroke has no area
+        if (m[0].x * m[1].y - m[1].x * m[0].y == 0)
+            return false;
+        localPoint = crunch::inverse(m) * _point;
+    }
+
+    return detail::StrokeOutliner::winding(localPoint, strokeOutlineLocal()) != 0;
+}
+
+bool Path::strokeContains(const Vec2f & _point) const
+{
+    return strokeContainsImpl(_point, nullptr);
+}
+
+bool Path::strokeContains(const Vec2f & _point, const Mat32f & _transform) const
+{
+    return strokeContainsImpl(_point, &_transform);
+}
+
+void Path::contains(const Vec2f * _points,
+                    Size _count,
+                    bool * _outResults,
+                    bool _bMultithreaded) const
+{
+    // degenerate transforms are rare enough to not need a fast path
+    if (isTransformed())
+    {
+        const Mat32f & m = absoluteTransform();
+        if (m[0].x * m[1].y - m[1].x * m[0].y == 0)
+        {
+            for (Size i = 0; i < _count; ++i)
+                _outResults[i] = containsImpl(_points[i], nullptr);
+            return;
+        }
+    }
+
+    // resolve all the lazily computed data before the threads only read it
+    detail::Shape shape;
+    bool bShape = analyticShape(nullptr, shape);
+    const Maybe<Rect> & bounds = cachedMonoCurveBounds();
+    const detail::MonoCurveLoopArray * loops = bShape ? nullptr : &cachedMonoCurves();
+    bool bEvenOdd = windingRule() == WindingRule::EvenOdd;
+    bool bTransformed = isTransformed();
+    Mat32f inverseTransform = bTransformed ? crunch::inverse(absoluteTransform()) : Mat32f::identity();
+
+    auto classify = [&](Size, Size _begin, Size _end) {
+        for (Size i = _begin; i < _end; ++i)
+        {
+            Vec2f p = bTransformed ? inverseTransform * _points[i] : _points[i];
+            if (bShape)
+            {
+                _outResults[i] = shape.contains(p);
+                continue;
+            }
+            if (!bounds || !bounds->contains(p))
+            {
+                _outResults[i] = false;
+                continue;
+            }
+
+            Int32 winding = detail::BooleanOperations::winding(p, *loops, false);
+            _outResults[i] = bEvenOdd ? winding & 1 : winding > 0;
+        }
+    };
+
+    detail::parallelFor(_count, _bMultithreaded ? detail::hardwareThreadCount() : 1, classify);
+}
+
+const detail::MonoCurveLoopArray & Path::cachedMonoCurves() const
+{
+    // item space, the children are added with their transform relative to this path.
+    if (m_monoCurves.count() == 0)
+    {
+        Mat32f identity = Mat32f::identity();
+        detail::BooleanOperations::monoCurves(this, m_monoCurves, &identity);
+        m_monoCurveBounds.reset();
+    }
+    return m_monoCurves;
+}
+
+const Maybe<Rect> & Path::cachedMonoCurveBounds() const
+{
+    const detail::MonoCurveLoopArray & loops = cachedMonoCurves();
+    if (m_monoCurveBounds)
+        return m_monoCurveBounds;
+
+    // the control points bound each curve, which is all the early out needs
+    for (const detail::MonoCurveLoop & loop : loops)
+    {
+        for (const detail::MonoCurve & c : loop.monoCurves)
+        {
+            const Bezier & b = c.bezier;
+            Rect r(b.positionOne(), b.positionOne());
+            r = crunch::merge(r, b.handleOne());
+            r = crunch::merge(r, b.handleTwo());
+            r = crunch::merge(r, b.positionTwo());
+            m_monoCurveBounds = m_monoCurveBounds ? crunch::merge(*m_monoCurveBounds, r) : r;
+        }
+    }
+    return m_monoCurveBounds;
+}
+
+bool Path::analyticShape(const Mat32f * _transform, detail::Shape & _out) const
+{
+    if (m_children.count())
+        return false;
+
+    if (!m_shape)
+        m_shape = detail::Shape(this);
+    if (m_shape->shapeType() == detail::ShapeType::None)
+        return false;
+
+    if (!_transform)
+    {
+        _out = *m_shape;
+        return true;
+    }
+    return m_shape->transformed(*_transform, _out);
+}
+
+Path * Path::unite(const Path * _other) const
+{
+    return detail::BooleanOperations::apply(this, _other, BooleanOperation::Unite);
+}
+
+Path * Path::intersect(const Path * _other) const
+{
+    return detail::BooleanOperations::apply(this, _other, BooleanOperation::Intersect);
+}
+
+Path * Path::subtract(const Path * _other) const
+{
+    return detail::BooleanOperations::apply(this, _other, BooleanOperation::Subtract);
+}
+
+Path * Path::exclude(const Path * _other) const
+{
+    return detail::BooleanOperations::apply(this, _other, BooleanOperation::Exclude);
+}
+
+Path * Path::divide(const Path * _other) const
+{
+    return detail::BooleanOperations::apply(this, _other, BooleanOperation::Divide);
+}
+
 Path * Path::clone() const
 {
     Path * ret = m_document->createPath(m_name.cString() ? m_name.cString() : "");
@@ -1830,6 +2809,10 @@ Path * Path::clone() const
     ret->m_bGeometryDirty = m_bGeometryDirty;
     ret->m_bIsClosed = m_bIsClosed;
     ret->m_length = m_length;
+    ret->m_moments = m_moments;
+    ret->m_curveOffsets = m_curveOffsets;
+    ret->m_arcLengths = m_arcLengths;
+    ret->m_shape = m_shape;
 
     // clone properties and children
     cloneItemTo(ret);
@@ -1871,139 +2854,6 @@ Size Path::segmentCount() const
     return m_segmentData.count();
 }
 
-namespace detail
-{
-static inline bool isAdjacentCurve(Size _a, Size _b, Size _curveCount, bool _bIsClosed)
-{
-    if (_b == _a + 1 || (_bIsClosed && _a == 0 && _b == _curveCount - 1))
-        return true;
-    return false;
-}
-
-static inline void intersectPaths(const Path * _self,
-                                  const Path * _other,
-                                  IntersectionArray & _intersections,
-                                  const Mat32f * _transformSelf,
-                                  const Mat32f * _transformOther)
-{
-    bool bSelf = _self == _other;
-
-    const SegmentDataArray *segmentsA, *segmentsB;
-    segmentsA = segmentsA = nullptr;
-    SegmentDataArray tmpA, tmpB;
-
-    if (!_transformSelf)
-        segmentsA = &_self->segmentData();
-    else
-    {
-        tmpA = _self->segmentData(*_transformSelf);
-        segmentsA = &tmpA;
-    }
-
-    if (bSelf)
-        segmentsB = segmentsA;
-    else if (!_transformOther)
-        segmentsB = &_other->segmentData();
-    else
-    {
-        tmpB = _other->segmentData(*_transformOther);
-        segmentsB = &tmpB;
-    }
-
-    STICK_ASSERT(segmentsA && segmentsB);
-    Bezier a, b;
-    for (Size i = 0; i < (_self->isClosed() ? segmentsA->count() : segmentsA->count() - 1); ++i)
-    {
-        auto & aa = (*segmentsA)[i];
-        auto & ab = (*segmentsA)[(i + 1) % segmentsA->count()];
-        a = Bezier(aa.position, aa.handleOut, ab.handleIn, ab.position);
-
-        for (Size j = bSelf ? i + 1 : 0;
-             j < (_other->isClosed() ? segmentsB->count() : segmentsB->count() - 1);
-             ++j)
-        {
-            auto & ba = (*segmentsB)[j];
-            auto & bb = (*segmentsB)[(j + 1) % segmentsB->count()];
-            b = Bezier(ba.position, ba.handleOut, bb.handleIn, bb.position);
-
-            auto intersections = a.intersections(b);
-            for (Int32 z = 0; z < intersections.count; ++z)
-            {
-                bool bAdd = true;
-                // for self intersection we only add the intersection if its not where
-                // adjacent curves connect.
-                if (bSelf)
-                {
-                    if (isAdjacentCurve(i, j, _self->curveCount(), _self->isClosed()))
-                    {
-                        if ((crunch::isClose(intersections.values[z].parameterOne,
-                                             1.0f,
-                                             detail::PaperConstants::curveTimeEpsilon()) &&
-                             crunch::isClose(intersections.values[z].parameterTwo,
-                                             0.0f,
-                                             detail::PaperConstants::curveTimeEpsilon())) ||
-                            // this case can only happen for closed paths where the first curve
-                            // meets the last one
-                            (_self->isClosed() &&
-                             crunch::isClose(intersections.values[z].parameterOne,
-                                             0.0f,
-                                             detail::PaperConstants::curveTimeEpsilon()) &&
-                             crunch::isClose(intersections.values[z].parameterTwo,
-                                             1.0f,
-                                             detail::PaperConstants::curveTimeEpsilon())))
-                        {
-                            bAdd = false;
-                        }
-                    }
-                }
-
-                if (bAdd)
-                {
-                    // @TODO: make sure we don't add an intersection twice. This can happen if the
-                    // intersection is located between two adjacent curves of the path.
-                    CurveLocation cl = _self->curve(i).curveLocationAtParameter(
-                        intersections.values[z].parameterOne);
-                    for (auto & isec : _intersections)
-                    {
-                        if (cl.isSynonymous(isec.location))
-                        {
-                            bAdd = false;
-                            break;
-                        }
-                    }
-                    if (bAdd)
-                    {
-                        _intersections.append({ cl, intersections.values[z].position });
-                    }
-                }
-            }
-        }
-    }
-}
-
-// helper to recursively intersect paths and its children (compound path)
-static inline void recursivelyIntersect(const Path * _self,
-                                        const Path * _other,
-                                        IntersectionArray & _intersections,
-                                        const Mat32f * _transformSelf,
-                                        const Mat32f * _transformOther)
-{
-    intersectPaths(_self, _other, _intersections, _transformSelf, _transformOther);
-
-    for (Item * c : _other->children())
-        recursivelyIntersect(
-            _self, static_cast<Path *>(c), _intersections, _transformSelf, _transformOther);
-}
-
-static inline void flattenPathChildren(const Path * _path,
-                                       stick::DynamicArray<const Path *> & _outPaths)
-{
-    _outPaths.append(_path);
-    for (Item * c : _path->children())
-        flattenPathChildren(static_cast<Path *>(c), _outPaths);
-}
-} // namespace detail
-
 IntersectionArray Path::intersections() const
 {
     return intersections(absoluteTransform());
@@ -2061,29 +2911,10 @@ void Path::intersectionsImpl(const Path * _other,
 {
     // @TODO: Take transformation matrix into account!!
     if (this != _other)
-    {
-        detail::recursivelyIntersect(
+        detail::PathIntersections::intersect(
             this, _other, _outIntersections, _transformSelf, _transformOther);
-
-        for (Size i = 0; i < m_children.count(); ++i)
-            detail::recursivelyIntersect(static_cast<Path *>(m_children[i]),
-                                         _other,
-                                         _outIntersections,
-                                         _transformSelf,
-                                         _transformOther);
-    }
     else
-    {
-        // for self intersection we create a flat list of all nested paths to avoid double
-        // comparisons
-        stick::DynamicArray<const Path *> paths(m_children.allocator());
-        paths.reserve(16);
-        detail::flattenPathChildren(this, paths);
-        for (Size i = 0; i < paths.count(); ++i)
-            for (Size j = i + 1; j < paths.count(); ++j)
-                detail::intersectPaths(
-                    paths[i], paths[j], _outIntersections, _transformSelf, _transformSelf);
-    }
+        detail::PathIntersections::intersectSelf(this, _outIntersections, _transformSelf);
 }
 
 void Path::markGeometryDirty(bool _bMarkLengthDirty, bool _bMarkParentsBoundsDirty)
@@ -2091,18 +2922,65 @@ void Path::markGeometryDirty(bool _bMarkLengthDirty, bool _bMarkParentsBoundsDir
     m_bGeometryDirty = true;
     markBoundsDirty(_bMarkParentsBoundsDirty);
     if (_bMarkLengthDirty)
+    {
         m_length.reset();
-    m_monoCurves.clear();
+        m_moments.reset();
+        m_curveOffsets.clear();
+        m_arcLengths.clear();
+    }
+    // give the memory of the polyline back, the path might never be flattened again
+    if (m_flattened.count())
+    {
+        DynamicArray<Vec2f> empty(m_flattened.allocator());
+        m_flattened.swap(empty);
+    }
+    m_shape.reset();
+    markStrokeOutlineDirty();
+    markMonoCurvesDirty();
     Item::markSymbolsDirty();
 
     for(auto * child : children())
         static_cast<Path*>(child)->markGeometryDirty(false, false);
 }
 
+void Path::markStrokeOutlineDirty()
+{
+    // compound paths contain the outline of their children
+    Path * p = this;
+    while (true)
+    {
+        p->m_bStrokeOutlineDirty = true;
+        if (!p->parent() || p->parent()->itemType() != ItemType::Path)
+            break;
+        p = static_cast<Path *>(p->parent());
+    }
+}
+
+void Path::markMonoCurvesDirty()
+{
+    // compound paths cache the mono curves of all their descendants
+    Path * p = this;
+    while (true)
+    {
+        p->m_monoCurves.clear();
+        if (!p->parent() || p->parent()->itemType() != ItemType::Path)
+            break;
+        p = static_cast<Path *>(p->parent());
+    }
+}
+
 void Path::transformChanged(bool _bCalledFromParent)
 {
     Item::transformChanged(_bCalledFromParent);
-    m_monoCurves.clear();
+
+    // the outline of a parent path contains this path relative to it.
+    if (!_bCalledFromParent && parent() && parent()->itemType() == ItemType::Path)
+        static_cast<Path *>(parent())->markStrokeOutlineDirty();
+
+    // our own mono curves are in item space and don't change, but the ones of the compound
+    // paths containing this path contain it relative to them.
+    if (!_bCalledFromParent && parent() && parent()->itemType() == ItemType::Path)
+        static_cast<Path *>(parent())->markMonoCurvesDirty();
 }
 
 bool Path::canAddChild(Item * _e) const
@@ -2128,6 +3006,15 @@ bool Path::performHitTest(const Vec2f & _pos,
             return true;
     }
 
+    if (_settings.testStroke() && !stroke().is<NoPaint>())
+    {
+        if (strokeContainsImpl(_pos, _transform))
+            _outResults.append({ (Item *)this, HitTestStroke });
+
+        if (!_bMultiple && startCount < _outResults.count())
+            return true;
+    }
+
     if (_settings.testFill() && !fill().is<NoPaint>())
     {
         if (containsImpl(_pos, _transform))
@@ -2180,6 +3067,8 @@ void Path::addedChild(Item * _e)
     while(parent->m_parent && parent->m_parent->itemType() == ItemType::Path)
         parent = static_cast<Path*>(parent->m_parent);
     parent->m_bContoursDirty = true;
+    markStrokeOutlineDirty();
+    markMonoCurvesDirty();
 
     _e->setStyle(m_style);
 }
@@ -2190,6 +3079,8 @@ void Path::removedChild(Item * _e)
     while(parent->m_parent && parent->m_parent->itemType() == ItemType::Path)
         parent = static_cast<Path*>(parent->m_parent);
     parent->m_bContoursDirty = true;
+    markStrokeOutlineDirty();
+    markMonoCurvesDirty();
 }
 
 static Mat32f strokeTransformHelper(const Mat32f & _transform,
@@ -2257,6 +3148,13 @@ Maybe<Rect> Path::computeFillBounds(const Mat32f * _transform, Float _padding) c
         return Rect(p, p);
     }
 
+    // the curves of axis aligned shapes have their extrema at the segments
+    detail::Shape shape;
+    if (analyticShape(_transform ? _transform : isTransformed() ? &absoluteTransform() : nullptr,
+                      shape) &&
+        shape.isAxisAligned())
+        return shape.bounds(_padding);
+
     Rect ret;
     if (!_transform && !isTransformed())
     {
@@ -2314,7 +3212,7 @@ Maybe<Rect> Path::computeFillBounds(const Mat32f * _transform, Float _padding) c
 
 Maybe<Rect> Path::computeStrokeBounds(const Mat32f * _transform) const
 {
-    if (!m_style->stroke().is<NoPaint>())
+    if (m_style->stroke().is<NoPaint>())
         return computeFillBounds(_transform, 0);
 
     StrokeJoin join = strokeJoin();
@@ -2338,17 +3236,40 @@ Maybe<Rect> Path::computeStrokeBounds(const Mat32f * _transform) const
     if (!result)
         return result;
 
+    // the joins of axis aligned shapes stay within the padded fill bounds
+    detail::Shape shape;
+    if (analyticShape(_transform, shape) && shape.isAxisAligned())
+        return result;
+
     Mat32f ismat = crunch::inverse(smat);
 
-    SegmentDataArray strokeSegs(m_segmentData.count(), m_segmentData.allocator());
-    for (Size i = 0; i < strokeSegs.count(); ++i)
+    // a single segment has no joins and no direction for its caps. The stroke outline caps it
+    // as if it pointed along the x axis of the stroke, butt caps leave nothing to draw.
+    Size count = m_segmentData.count();
+    if (count < 2)
+    {
+        if (cap != StrokeCap::Butt)
+        {
+            Vec2f pos = ismat * m_segmentData[0].position;
+            SegmentData dot = { pos, pos, pos };
+            SegmentData left = { pos - Vec2f(1, 0), pos - Vec2f(1, 0), pos - Vec2f(1, 0) };
+            SegmentData right = { pos + Vec2f(1, 0), pos + Vec2f(1, 0), pos + Vec2f(1, 0) };
+            detail::mergeStrokeCap(*result, cap, left, dot, false, sp, smat, _transform);
+            detail::mergeStrokeCap(*result, cap, right, dot, false, sp, smat, _transform);
+        }
+        return result;
+    }
+
+    detail::ScratchScope scratch;
+    SegmentDataArray strokeSegs(count, scratch.allocator());
+    for (Size i = 0; i < count; ++i)
     {
-        strokeSegs[i] = { ismat * (m_segmentData[i].position + m_segmentData[i].handleIn),
+        strokeSegs[i] = { ismat * m_segmentData[i].handleIn,
                           ismat * m_segmentData[i].position,
-                          ismat * (m_segmentData[i].position + m_segmentData[i].handleOut) };
+                          ismat * m_segmentData[i].handleOut };
     }
 
-    for (Size i = 1; i < m_segmentData.count(); ++i)
+    for (Size i = 1; i < count - 1; ++i)
     {
         detail::mergeStrokeJoin(*result,
                                 join,
@@ -2363,11 +3284,20 @@ Maybe<Rect> Path::computeStrokeBounds(const Mat32f * _transform) const
 
     if (isClosed())
     {
-        // closing join
+        // the joins at the last and the first segment
         detail::mergeStrokeJoin(*result,
                                 join,
                                 ml,
-                                strokeSegs[strokeSegs.count() - 1],
+                                strokeSegs[count - 2],
+                                strokeSegs[count - 1],
+                                strokeSegs[0],
+                                sp,
+                                smat,
+                                _transform);
+        detail::mergeStrokeJoin(*result,
+                                join,
+                                ml,
+                                strokeSegs[count - 1],
                                 strokeSegs[0],
                                 strokeSegs[1],
                                 sp,
@@ -2381,8 +3311,8 @@ Maybe<Rect> Path::computeStrokeBounds(const Mat32f * _transform) const
             *result, cap, strokeSegs[0], strokeSegs[1], true, sp, smat, _transform);
         detail::mergeStrokeCap(*result,
                                cap,
-                               strokeSegs[strokeSegs.count() - 2],
-                               strokeSegs[strokeSegs.count() - 1],
+                               strokeSegs[count - 2],
+                               strokeSegs[count - 1],
                                false,
                                sp,
                                smat,
@@ -2400,20 +3330,22 @@ Maybe<Rect> Path::computeHandleBounds(const Mat32f * _transform) const
     if (!ret)
         return ret;
 
+    // the handles are absolute and in the same space as the stroke bounds
+    _transform = _transform ? _transform : isTransformed() ? &absoluteTransform() : nullptr;
     if (_transform)
     {
         for (auto & seg : m_segmentData)
         {
-            ret = crunch::merge(*ret, *_transform * (seg.position + seg.handleIn));
-            ret = crunch::merge(*ret, *_transform * (seg.position + seg.handleOut));
+            ret = crunch::merge(*ret, *_transform * seg.handleIn);
+            ret = crunch::merge(*ret, *_transform * seg.handleOut);
         }
     }
     else
     {
         for (auto & seg : m_segmentData)
         {
-            ret = crunch::merge(*ret, seg.position + seg.handleIn);
-            ret = crunch::merge(*ret, seg.position + seg.handleIn);
+            ret = crunch::merge(*ret, seg.handleIn);
+            ret = crunch::merge(*ret, seg.handleOut);
         }
     }
 
@@ -2435,16 +3367,13 @@ Maybe<Rect> Path::computeBounds(const Mat32f * _transform, BoundsType _type) con
 
 void Path::applyTransformToSegment(Size _index, const Mat32f & _transform)
 {
-    SegmentData & segData = m_segmentData[_index];
-    segData.handleIn = _transform * segData.handleIn;
-    segData.handleOut = _transform * segData.handleOut;
-    segData.position = _transform * segData.position;
+    segments::transform(_transform, &m_segmentData[_index], &m_segmentData[_index], 1);
 }
 
 void Path::applyTransform(const Mat32f & _transform, bool _bMarkParentsBoundsDirty)
 {
-    for (Size i = 0; i < m_segmentData.count(); ++i)
-        applyTransformToSegment(i, _transform);
+    if (m_segmentData.count())
+        segments::transform(_transform, &m_segmentData[0], &m_segmentData[0], m_segmentData.count());
 
     for (Size i = 0; i < m_curveData.count(); ++i)
         m_curveData[i] = CurveData{};
@@ -4,12 +4,18 @@
 #include <Paper2/Item.hpp>
 #include <Paper2/Private/BooleanOperations.hpp>
 #include <Paper2/Private/ContainerView.hpp>
+#include <Paper2/Private/Shape.hpp>
 
 namespace paper
 {
 class Path;
 class CurveLocation;
 
+namespace detail
+{
+class DashPattern;
+}
+
 template <class PT>
 class CurveT;
 
@@ -279,6 +285,20 @@ struct STICK_API Intersection
 
 using IntersectionArray = stick::DynamicArray<Intersection>;
 
+// integrals over the area enclosed by a path, signed like Path::area. Open paths are closed with
+// a straight line like for the area.
+struct STICK_API Moments
+{
+    // the signed area
+    Float area;
+    // the integrals of x and y
+    Vec2f first;
+    // the integrals of x * x and y * y
+    Vec2f second;
+    // the integral of x * y
+    Float product;
+};
+
 namespace segments
 {
 void addPoint(SegmentDataArray & _segs, const Vec2f & _to);
@@ -329,6 +349,36 @@ Error arcHelper(SegmentDataArray & _segs,
                 const Vec2f & _to,
                 const Vec2f & _center,
                 const Mat32f * _transform);
+
+// transforms all positions and handles of _count segments from _in to _out, which may point to
+// the same array. Considerably faster than transforming one Vec2f at a time for large counts.
+void transform(const Mat32f & _transform, const SegmentData * _in, SegmentData * _out, Size _count);
+
+// the moments of the area enclosed by _count segments, computed in a single pass over the curves.
+Moments moments(const SegmentData * _segments, Size _count, bool _bClosed);
+
+// sets the handles of the segments in [_from, _to] like Path::smooth does. Returns false if
+// there is nothing to smooth.
+bool smooth(SegmentData * _segments,
+            Size _count,
+            bool _bClosed,
+            Int64 _from,
+            Int64 _to,
+            Smoothing _type);
+
+// re-smooths the segments in [_from, _to] and _padding segments on either side of them, keeping
+// the handles of the segments bounding that window. Expects the segments to be smoothed with
+// _type before. The first and last changed segment are written to _outFirst and _outLast.
+// Returns false if there is nothing to smooth.
+bool smoothAround(SegmentData * _segments,
+                  Size _count,
+                  bool _bClosed,
+                  Int64 _from,
+                  Int64 _to,
+                  Smoothing _type,
+                  Size _padding,
+                  Int64 * _outFirst,
+                  Int64 * _outLast);
 } // namespace segments
 
 class STICK_API Path : public Item
@@ -338,6 +388,7 @@ class STICK_API Path : public Item
     template <class T>
     friend class CurveT;
     friend class RenderInterface;
+    friend class Document;
     friend struct detail::BooleanOperations;
 
   public:
@@ -388,6 +439,17 @@ class STICK_API Path : public Item
 
     void smooth(Int64 _from, Int64 _to, Smoothing _type = Smoothing::Asymmetric);
 
+    // smooths the path again after the segments in [_from, _to] moved, i.e. while dragging them.
+    // The path is expected to be smoothed with _type already. Moving a segment barely affects the
+    // smoothed handles a few segments away, so only _padding segments on either side are solved
+    // again and the rest keep their handles, which makes the cost independent of the path length.
+    // On closed paths the result near the first segment can differ slightly from smooth(), which
+    // only approximates the wrap around.
+    void smoothAround(Int64 _from,
+                      Int64 _to,
+                      Smoothing _type = Smoothing::Asymmetric,
+                      Size _padding = 8);
+
     void simplify(Float _tolerance = 2.5);
 
     void addSegment(const Vec2f & _point, const Vec2f & _handleIn, const Vec2f & _handleOut);
@@ -447,6 +509,35 @@ class STICK_API Path : public Item
 
     void flattenRegular(Float _maxDistance, bool _bFlattenChildren = false);
 
+    // the positions that flatten() would produce for this path (without its children), in item
+    // space. This is the opt-in polyline cache of the path: the first call flattens and keeps
+    // the result until the geometry changes, repeated calls with the same arguments only return
+    // the cached positions. The stroke outline is built from it and flatten() reuses it while
+    // it is valid, but does not fill it.
+    const stick::DynamicArray<Vec2f> & flattenedPositions(Float _angleTolerance = 0.25,
+                                                          Float _minDistance = 0.0,
+                                                          Size _maxRecursion = 32) const;
+
+    // the outline of the stroke of this path and its children as polygons in item space. It
+    // honors stroke width, joins, caps, miter limit and dashes and is built from the flattened
+    // positions. Filled with the non zero winding rule, the polygons cover the same area as the
+    // stroke. The result is cached until the geometry or the stroke style changes.
+    const PolygonArray & strokeOutlineLocal() const;
+
+    // creates a new path from the stroke outline that is filled with the stroke paint of this
+    // path. It is inserted above this path and takes over its transform.
+    Path * strokeOutline() const;
+
+    // splits this path and its children into one open path per dash, i.e. the dashes that the
+    // renderer would draw, measured in item space. The dashes are exact slices of the curves and
+    // are found through a cached arc length table, so this is linear in the number of curves
+    // and dashes. The first dash is the returned path, all others are its children. It is
+    // inserted above this path, takes over its transform and style but is neither filled nor
+    // dashed. If the dash array does not dash, the contours are copied as they are.
+    Path * dashed() const;
+
+    Path * dashed(const DashArray & _dashArray, Float _dashOffset) const;
+
     struct OffsetAndSampleCount
     {
         Float offset;
@@ -493,6 +584,15 @@ class STICK_API Path : public Item
 
     CurveLocation curveLocationAt(Float _offset) const;
 
+    // evaluates the path at _count offsets at once. Sorted offsets are evaluated in a single pass
+    // over the curves, unsorted ones fall back to a binary search per offset. Any of the output
+    // arrays may be nullptr, otherwise they need to have room for _count elements.
+    void sampleAt(const Float * _offsets,
+                  Size _count,
+                  Vec2f * _outPositions,
+                  Vec2f * _outTangents = nullptr,
+                  Vec2f * _outNormals = nullptr) const;
+
     void peaks(stick::DynamicArray<CurveLocation> & _peaks) const;
 
     void extrema(stick::DynamicArray<CurveLocation> & _extrema) const;
@@ -501,8 +601,16 @@ class STICK_API Path : public Item
 
     Float length() const;
 
+    // signed area, positive if the path is clockwise. Children are included, so holes with the
+    // opposite orientation are subtracted.
     Float area() const;
 
+    // the moments of the area including the children, see Moments.
+    Moments moments() const;
+
+    // the center of mass of the area. Zero if the path has no area.
+    Vec2f centroid() const;
+
     bool isClosed() const;
 
     bool isPolygon() const;
@@ -513,6 +621,34 @@ class STICK_API Path : public Item
 
     bool contains(const Vec2f & _p) const;
 
+    // true if _p lies in the area covered by the stroke (see strokeOutlineLocal). This does not
+    // check if the path has a stroke paint.
+    bool strokeContains(const Vec2f & _p, const Mat32f & _transform) const;
+
+    bool strokeContains(const Vec2f & _p) const;
+
+    // classifies _count points at once, _outResults needs room for _count elements. The
+    // curves, bounds and winding rule are only resolved once for all points. If _bMultithreaded
+    // is true, the points are spread over all hardware threads.
+    void contains(const Vec2f * _points,
+                  Size _count,
+                  bool * _outResults,
+                  bool _bMultithreaded = false) const;
+
+    // boolean operations like in paper.js. They are computed in the local space of this path,
+    // the result is a new path that is inserted above this path and takes over its style and
+    // transform. Results with multiple contours are compound paths.
+    Path * unite(const Path * _other) const;
+
+    Path * intersect(const Path * _other) const;
+
+    Path * subtract(const Path * _other) const;
+
+    Path * exclude(const Path * _other) const;
+
+    // the parts of this path outside and inside of _other, as one compound path.
+    Path * divide(const Path * _other) const;
+
     Path * clone() const final;
 
     SegmentView segments();
@@ -567,6 +703,21 @@ class STICK_API Path : public Item
   private:
     bool containsImpl(const Vec2f & _p, const Mat32f * _transform) const;
 
+    bool strokeContainsImpl(const Vec2f & _p, const Mat32f * _transform) const;
+
+    const detail::MonoCurveLoopArray & cachedMonoCurves() const;
+
+    // item space bounds of the cached mono curves, empty if there are none
+    const stick::Maybe<Rect> & cachedMonoCurveBounds() const;
+
+    // the moments of the segments of this path without the children
+    const Moments & contourMoments() const;
+
+    // the recognized circle, ellipse or rectangle this path describes, in the space of
+    // _transform or in item space if it is nullptr. Returns false if the path is no such shape,
+    // has children or the transform rotates or skews the shape.
+    bool analyticShape(const Mat32f * _transform, detail::Shape & _out) const;
+
     bool canAddChild(Item * _e) const final;
 
     bool performHitTest(const Vec2f & _pos,
@@ -591,6 +742,12 @@ class STICK_API Path : public Item
 
     void rebuildCurves();
 
+    const stick::DynamicArray<Float> & curveOffsets() const;
+
+    const stick::DynamicArray<Float> & arcLengths() const;
+
+    void addDashes(detail::DashPattern & _pattern, const Mat32f * _transform, Path * _target) const;
+
     stick::Maybe<Rect> computeFillBounds(const Mat32f * _transform, Float _padding) const;
 
     stick::Maybe<Rect> computeHandleBounds(const Mat32f * _transform) const;
@@ -613,6 +770,27 @@ class STICK_API Path : public Item
 
     void markGeometryDirty(bool _bMarkLengthDirty, bool _bMarkParentsBoundsDirty = true);
 
+    // marks the stroke outline of this path and of all compound paths containing it dirty.
+    void markStrokeOutlineDirty();
+
+    // clears the mono curves of this path and of all compound paths containing it.
+    void markMonoCurvesDirty();
+
+    // true if flattenedPositions has a valid cache for these arguments
+    bool hasFlattenedPositions(Float _angleTolerance, Float _minDistance, Size _maxRecursion) const;
+
+    // the segments that simplify, flatten and smooth set on this path, computed without changing
+    // the path. They return false if the path stays the same. Only caches of this path are
+    // touched, so different paths can be processed in parallel (see Document::simplifyPaths).
+    bool simplifiedSegments(Float _tolerance, SegmentDataArray & _outSegments) const;
+
+    bool flattenedSegments(Float _angleTolerance,
+                           Float _minDistance,
+                           Size _maxRecursion,
+                           SegmentDataArray & _outSegments) const;
+
+    bool smoothedSegments(Smoothing _type, SegmentDataArray & _outSegments) const;
+
     void appendedSegments(Size _count);
 
     SegmentDataArray m_segmentData;
@@ -621,9 +799,45 @@ class STICK_API Path : public Item
 
     // for hit testing
     mutable detail::MonoCurveLoopArray m_monoCurves;
+    mutable stick::Maybe<Rect> m_monoCurveBounds;
 
     // rendering related
     mutable stick::Maybe<Float> m_length;
+    // see contourMoments. Empty if dirty.
+    mutable stick::Maybe<Moments> m_moments;
+    // offset of the start of each curve along the path, the last entry is the length of the
+    // path. Empty if dirty.
+    mutable stick::DynamicArray<Float> m_curveOffsets;
+    // offsets along the path at regular parameter steps of each curve, used to map offsets to
+    // curve parameters without integrating. The last entry is the length of the path. Empty if
+    // dirty.
+    mutable stick::DynamicArray<Float> m_arcLengths;
+    // the shape recognized from the segments, so queries on circles, ellipses and rectangles can
+    // use closed form math. Empty if dirty.
+    mutable stick::Maybe<detail::Shape> m_shape;
+    // cached result of flattenedPositions and the arguments it was computed with. Empty if dirty.
+    struct FlatteningSettings
+    {
+        Float angleTolerance;
+        Float minDistance;
+        Size maxRecursion;
+    };
+    mutable stick::DynamicArray<Vec2f> m_flattened;
+    mutable FlatteningSettings m_flatteningSettings;
+    // cached result of strokeOutlineLocal and the stroke settings it was computed with.
+    struct StrokeOutlineSettings
+    {
+        Float strokeWidth;
+        StrokeJoin strokeJoin;
+        StrokeCap strokeCap;
+        Float miterLimit;
+        DashArray dashArray;
+        Float dashOffset;
+        Mat32f strokeTransform;
+    };
+    mutable PolygonArray m_strokeOutline;
+    mutable StrokeOutlineSettings m_strokeOutlineSettings;
+    mutable bool m_bStrokeOutlineDirty;
     bool m_bGeometryDirty;
     bool m_bContoursDirty; //true if a child path was added/removed somewhere down the hierarchy
 };
@@ -773,6 +987,7 @@ void SegmentT<PT>::segmentChanged()
         ci.markDirty();
     if (co)
         co.markDirty();
+    m_path->markGeometryDirty(true);
 }
 
 template <class PT>
@@ -1040,17 +1255,7 @@ Float CurveT<PT>::lengthBetween(Float _tStart, Float _tEnd) const
 template <class PT>
 Float CurveT<PT>::pathOffset() const
 {
-    // calculate the offset from the start to the curve location
-    Float offset = 0;
-    for (ConstCurve c : m_path->curves())
-    {
-        if (c.m_index != m_index)
-            offset += c.length();
-        else
-            break;
-    }
-
-    return offset;
+    return m_path->curveOffsets()[m_index];
 }
 
 template <class PT>
@@ -1,8 +1,13 @@
+#include <Paper2/Document.hpp>
 #include <Paper2/Path.hpp>
+#include <Paper2/Private/Broadphase.hpp>
+#include <Paper2/Private/SweepLine.hpp>
 
 #include <Crunch/MatrixFunc.hpp>
 #include <Crunch/StringConversion.hpp>
 
+#include <algorithm>
+
 namespace paper
 {
 namespace detail
@@ -99,6 +104,58 @@ static void handleCurve(const Bezier & _c, MonoCurveLoop & _target)
     }
 }
 
+static void buildYIndex(MonoCurveLoop & _loop)
+{
+    // scanning a few curves is faster than looking them up
+    const MonoCurveArray & curves = _loop.monoCurves;
+    if (curves.count() < 16)
+        return;
+
+    MonoCurveYIndex & index = _loop.yIndex;
+    index.min = std::numeric_limits<Float>::infinity();
+    index.max = -std::numeric_limits<Float>::infinity();
+    for (const MonoCurve & c : curves)
+    {
+        index.min = std::min(index.min, std::min(c.bezier.positionOne().y, c.bezier.positionTwo().y));
+        index.max = std::max(index.max, std::max(c.bezier.positionOne().y, c.bezier.positionTwo().y));
+    }
+    if (!(index.max > index.min))
+        return;
+
+    // about one bucket per curve. Mono curves are split at their y extrema, so on outlines
+    // most of them only overlap a couple of buckets.
+    Size bucketCount = curves.count();
+    index.scale = bucketCount / (index.max - index.min);
+    auto bucket = [&](Float _y) {
+        return std::min((Size)((_y - index.min) * index.scale), bucketCount - 1);
+    };
+
+    index.starts.clear();
+    index.starts.resize(bucketCount + 1, 0);
+    for (const MonoCurve & c : curves)
+    {
+        Float y0 = c.bezier.positionOne().y;
+        Float y1 = c.bezier.positionTwo().y;
+        Size last = bucket(std::max(y0, y1));
+        for (Size b = bucket(std::min(y0, y1)); b <= last; ++b)
+            ++index.starts[b + 1];
+    }
+    for (Size b = 0; b < bucketCount; ++b)
+        index.starts[b + 1] += index.starts[b];
+
+    // fill in curve order so every bucket lists its curves in the order of the loop
+    DynamicArray<UInt32> fill(index.starts);
+    index.curves.resize(index.starts.last());
+    for (Size i = 0; i < curves.count(); ++i)
+    {
+        Float y0 = curves[i].bezier.positionOne().y;
+        Float y1 = curves[i].bezier.positionTwo().y;
+        Size last = bucket(std::max(y0, y1));
+        for (Size b = bucket(std::min(y0, y1)); b <= last; ++b)
+            index.curves[fill[b]++] = (UInt32)i;
+    }
+}
+
 void BooleanOperations::monoCurves(const Path * _path, MonoCurveLoopArray & _outLoops, const Mat32f * _transform)
 {
     MonoCurveLoop data;
@@ -138,6 +195,7 @@ void BooleanOperations::monoCurves(const Path * _path, MonoCurveLoopArray & _out
         handleCurve(tmp, data);
     }
 
+    buildYIndex(data);
     _outLoops.append(data);
 
     Mat32f tmp;
@@ -184,6 +242,7 @@ const MonoCurveLoopArray & BooleanOperations::monoCurves(const Path * _path)
             handleCurve(tmp, data);
         }
 
+        buildYIndex(data);
         _path->m_monoCurves.append(data);
 
         // If this is a compound path, get the child mono curves and append them
@@ -267,23 +326,44 @@ Int32 BooleanOperations::winding(const Vec2f & _point,
             Vec2f p = /*loop.bTransformed ? loop.inverseTransform * _point : */ _point;
             xBefore = p.x - epsilon;
             xAfter = p.x + epsilon;
-            for (Size i = 0; i < loop.monoCurves.count(); ++i)
+            if (!loop.monoCurves.count())
+                continue;
+
+            // The first curve of a loop holds the last curve with non-zero
+            // winding. Retrieve and use it here.
+            prevWinding = loop.last.winding;
+            prevXEnd = loop.last.bezier.positionTwo().x;
+            // Reset the on curve flag for each loop.
+            bIsOnCurve = false;
+
+            // Only curves whose y range contains the point can change the state below, so it
+            // is enough to visit the ones in the bucket of the point if the loop is indexed.
+            const MonoCurveYIndex & index = loop.yIndex;
+            const UInt32 * bucketBegin = nullptr;
+            const UInt32 * bucketEnd = nullptr;
+            Size visitCount = loop.monoCurves.count();
+            if (index.starts.count())
             {
+                if (p.y < index.min || p.y > index.max)
+                    visitCount = 0;
+                else
+                {
+                    Size b = std::min((Size)((p.y - index.min) * index.scale),
+                                      index.starts.count() - 2);
+                    bucketBegin = index.curves.begin() + index.starts[b];
+                    bucketEnd = index.curves.begin() + index.starts[b + 1];
+                    visitCount = bucketEnd - bucketBegin;
+                }
+            }
+
+            for (Size k = 0; k < visitCount; ++k)
+            {
+                Size i = bucketBegin ? bucketBegin[k] : k;
                 const MonoCurve & curve = loop.monoCurves[i];
                 Float yStart = curve.bezier.positionOne().y;
                 Float yEnd = curve.bezier.positionTwo().y;
                 Int32 winding = curve.winding;
 
-                // The first curve of a loop holds the last curve with non-zero
-                // winding. Retrieve and use it here.
-                if (i == 0)
-                {
-                    prevWinding = loop.last.winding;
-                    prevXEnd = loop.last.bezier.positionTwo().x;
-                    // Reset the on curve flag for each loop.
-                    bIsOnCurve = false;
-                }
-
                 // Since the curves are monotonic in y direction, we can just
                 // compare the endpoints of the curve to determine if the ray
                 // from query point along +-x direction will intersect the
@@ -359,15 +439,15 @@ Int32 BooleanOperations::winding(const Vec2f & _point,
                         bIsOnCurve = true;
                     }
                 }
+            }
 
-                // If we are at the end of a loop and the point was on a curve
-                // of the loop, we increment / decrement the on-curve winding
-                // numbers as if the point was inside the path.
-                if (bIsOnCurve && (i >= loop.monoCurves.count() - 1))
-                {
-                    windLeftOnCurve += 1;
-                    windRightOnCurve -= 1;
-                }
+            // If we are at the end of a loop and the point was on a curve
+            // of the loop, we increment / decrement the on-curve winding
+            // numbers as if the point was inside the path.
+            if (bIsOnCurve)
+            {
+                windLeftOnCurve += 1;
+                windRightOnCurve -= 1;
             }
         }
 
@@ -384,5 +464,625 @@ Int32 BooleanOperations::winding(const Vec2f & _point,
     return max(abs(windingLeft), abs(windingRight));
 }
 
+// Boolean operations
+//
+// Both operands are split at their intersections with each other and with themselves and put
+// into one graph of nodes (segments). Every resulting curve lies completely in- or outside of
+// both operands, so we can decide whether it is part of the result by probing the result on both
+// sides of its center. Curves that have the result on exactly one side are kept and oriented so
+// the result is on the same side for all of them. The kept curves are then traced into closed
+// contours, switching between the operands where they intersect.
+// Where the operands share a piece of their outline (i.e. adjacent tiles), both are split at the
+// ends of the overlap and only the piece of the first operand is considered for the result.
+
+// an intersection connects two nodes of the graph, which are recorded in two slots. The first
+// one, 2 * index, belongs to the first curve and 2 * index + 1 to the second one.
+struct CurveSplit
+{
+    Float parameter;
+    Size slot;
+};
+
+using CurveSplitArray = DynamicArray<CurveSplit>;
+
+// the piece of a curve of the second operand between two intersection slots that is shared with
+// the first operand.
+struct CurveOverlap
+{
+    Size startSlot;
+    Size endSlot;
+};
+
+static Float lineDistance(const Vec2f & _a, const Vec2f & _b, const Vec2f & _p)
+{
+    Vec2f dir = _b - _a;
+    Float len = crunch::length(dir);
+    if (len < PaperConstants::epsilon())
+        return crunch::distance(_a, _p);
+    return crunch::abs(dir.x * (_p.y - _a.y) - dir.y * (_p.x - _a.x)) / len;
+}
+
+static bool isStraight(const Bezier & _c)
+{
+    Float eps = PaperConstants::geometricEpsilon();
+    Vec2f line = _c.positionTwo() - _c.positionOne();
+    Float d = crunch::dot(line, line);
+    if (d < PaperConstants::epsilon())
+        return crunch::isClose(_c.handleOne(), _c.positionOne(), eps) &&
+               crunch::isClose(_c.handleTwo(), _c.positionTwo(), eps);
+
+    // the handles have to be on the line and within its range
+    Float p1 = crunch::dot(line, _c.handleOne() - _c.positionOne()) / d;
+    Float p2 = crunch::dot(line, _c.handleTwo() - _c.positionOne()) / d;
+    return lineDistance(_c.positionOne(), _c.positionTwo(), _c.handleOne()) < eps &&
+           lineDistance(_c.positionOne(), _c.positionTwo(), _c.handleTwo()) < eps &&
+           p1 >= 0 && p1 <= 1 && p2 >= 0 && p2 <= 1;
+}
+
+// the parameter of _p on _c or -1 if it is not on the curve.
+static Float parameterOf(const Bezier & _c, const Vec2f & _p)
+{
+    Float eps = PaperConstants::geometricEpsilon();
+    if (crunch::isClose(_p, _c.positionOne(), eps))
+        return 0;
+    if (crunch::isClose(_p, _c.positionTwo(), eps))
+        return 1;
+    Float dist;
+    Float t = _c.closestParameter(_p, dist, 0, 1, 0);
+    return dist < eps ? t : -1;
+}
+
+// paper.js Curve.getOverlaps. If _a and _b share a piece of their outline, _outPairs receives the
+// parameters of its ends on _a and _b.
+static bool overlaps(const Bezier & _a, const Bezier & _b, Float (&_outPairs)[2][2])
+{
+    Float eps = PaperConstants::geometricEpsilon();
+    bool bStraightA = isStraight(_a);
+    bool bStraightB = isStraight(_b);
+    bool bStraightBoth = bStraightA && bStraightB;
+
+    // the line through the longer curve
+    bool bFlip = crunch::distance(_a.positionOne(), _a.positionTwo()) <
+                 crunch::distance(_b.positionOne(), _b.positionTwo());
+    const Bezier & l1 = bFlip ? _b : _a;
+    const Bezier & l2 = bFlip ? _a : _b;
+    Vec2f p = l1.positionOne();
+    Vec2f q = l1.positionTwo();
+    if (lineDistance(p, q, l2.positionOne()) < eps && lineDistance(p, q, l2.positionTwo()) < eps)
+    {
+        // curves that are not straight are treated like that if all handles are on the line
+        if (!bStraightBoth && lineDistance(p, q, l1.handleOne()) < eps &&
+            lineDistance(p, q, l1.handleTwo()) < eps && lineDistance(p, q, l2.handleOne()) < eps &&
+            lineDistance(p, q, l2.handleTwo()) < eps)
+        {
+            bStraightA = bStraightB = bStraightBoth = true;
+        }
+    }
+    else if (bStraightBoth)
+        return false;
+
+    if (bStraightA != bStraightB)
+        return false;
+
+    // the end points of each curve that are on the other one
+    const Bezier * curves[2] = { &_a, &_b };
+    Size count = 0;
+    for (Size i = 0; i < 4 && count < 2; ++i)
+    {
+        Size i1 = i & 1;
+        Size i2 = i1 ^ 1;
+        Size end = i >> 1;
+        Vec2f point = end ? curves[i2]->positionTwo() : curves[i2]->positionOne();
+        Float t = parameterOf(*curves[i1], point);
+        if (t >= 0)
+        {
+            Float pair[2];
+            pair[i1] = t;
+            pair[i2] = end;
+            // tiny overlaps are ignored
+            Float tEps = PaperConstants::curveTimeEpsilon();
+            if (!count || (crunch::abs(pair[0] - _outPairs[0][0]) > tEps &&
+                           crunch::abs(pair[1] - _outPairs[0][1]) > tEps))
+            {
+                _outPairs[count][0] = pair[0];
+                _outPairs[count][1] = pair[1];
+                ++count;
+            }
+        }
+
+        // three end points and none on the other curve
+        if (i > 2 && !count)
+            break;
+    }
+
+    if (count != 2)
+        return false;
+    if (bStraightBoth)
+        return true;
+
+    // the overlapping pieces of curves need the same handles, too
+    Bezier pa = _a.slice(stick::min(_outPairs[0][0], _outPairs[1][0]),
+                         stick::max(_outPairs[0][0], _outPairs[1][0]));
+    Bezier pb = _b.slice(stick::min(_outPairs[0][1], _outPairs[1][1]),
+                         stick::max(_outPairs[0][1], _outPairs[1][1]));
+    if ((_outPairs[0][0] < _outPairs[1][0]) != (_outPairs[0][1] < _outPairs[1][1]))
+        pb = Bezier(pb.positionTwo(), pb.handleTwo(), pb.handleOne(), pb.positionOne());
+    return crunch::isClose(pa.handleOne(), pb.handleOne(), eps) &&
+           crunch::isClose(pa.handleTwo(), pb.handleTwo(), eps);
+}
+
+// splits _a and _b where they intersect or where their overlap starts and ends. Returns true
+// for overlaps, in which case _outOverlap is the piece of _b between the two intersections.
+static bool addIntersections(const Bezier & _a,
+                             CurveSplitArray & _splitsA,
+                             const Bezier & _b,
+                             CurveSplitArray & _splitsB,
+                             Size & _intersectionCount,
+                             CurveOverlap & _outOverlap)
+{
+    Float pairs[2][2];
+    if (overlaps(_a, _b, pairs))
+    {
+        Size first = _intersectionCount;
+        for (Size z = 0; z < 2; ++z, ++_intersectionCount)
+        {
+            _splitsA.append({ pairs[z][0], _intersectionCount * 2 });
+            _splitsB.append({ pairs[z][1], _intersectionCount * 2 + 1 });
+        }
+        // the slots of _b, ordered along _b
+        bool bInOrder = pairs[0][1] < pairs[1][1];
+        _outOverlap = { (bInOrder ? first : first + 1) * 2 + 1,
+                        (bInOrder ? first + 1 : first) * 2 + 1 };
+        return true;
+    }
+
+    auto intersections = _a.intersections(_b);
+    for (Int32 z = 0; z < intersections.count; ++z, ++_intersectionCount)
+    {
+        _splitsA.append({ intersections.values[z].parameterOne, _intersectionCount * 2 });
+        _splitsB.append({ intersections.values[z].parameterTwo, _intersectionCount * 2 + 1 });
+    }
+    return false;
+}
+
+struct BooleanEdge
+{
+    Size node;
+    bool bReversed;
+};
+
+struct STICK_LOCAL BooleanGraph
+{
+    BooleanGraph(Allocator & _alloc) : nodes(_alloc), next(_alloc), vertices(_alloc)
+    {
+    }
+
+    Size vertex(Size _node) const
+    {
+        Size v = _node;
+        while (vertices[v] != v)
+            v = vertices[v];
+        return v;
+    }
+
+    void join(Size _a, Size _b)
+    {
+        Size va = vertex(_a);
+        Size vb = vertex(_b);
+        if (va != vb)
+            vertices[stick::max(va, vb)] = stick::min(va, vb);
+    }
+
+    Size startNode(const BooleanEdge & _e) const
+    {
+        return _e.bReversed ? next[_e.node] : _e.node;
+    }
+
+    Size endNode(const BooleanEdge & _e) const
+    {
+        return _e.bReversed ? _e.node : next[_e.node];
+    }
+
+    Bezier bezier(Size _node) const
+    {
+        const SegmentData & a = nodes[_node];
+        const SegmentData & b = nodes[next[_node]];
+        return Bezier(a.position, a.handleOut, b.handleIn, b.position);
+    }
+
+    Bezier bezier(const BooleanEdge & _e) const
+    {
+        const SegmentData & a = nodes[startNode(_e)];
+        const SegmentData & b = nodes[endNode(_e)];
+        return _e.bReversed ? Bezier(a.position, a.handleIn, b.handleOut, b.position)
+                            : Bezier(a.position, a.handleOut, b.handleIn, b.position);
+    }
+
+    SegmentDataArray nodes;
+    // the next node along the contour
+    DynamicArray<Size> next;
+    // nodes at the same position (intersections) share a vertex, this is the parent of the node
+    // in a union find structure.
+    DynamicArray<Size> vertices;
+};
+
+static void collectContours(const Path * _path,
+                            const Mat32f & _transform,
+                            DynamicArray<SegmentDataArray> & _outContours)
+{
+    if (_path->segmentData().count() > 1)
+    {
+        _outContours.append(_path->segmentData(_transform));
+
+        // open paths are filled as if they were closed with a straight line, so we treat them
+        // like that.
+        if (!_path->isClosed())
+        {
+            SegmentDataArray & segs = _outContours.last();
+            segs.last().handleOut = segs.last().position;
+            segs.first().handleIn = segs.first().position;
+        }
+    }
+
+    Mat32f tmp;
+    for (Item * c : _path->children())
+    {
+        tmp = _transform * c->transform();
+        collectContours(static_cast<Path *>(c), tmp, _outContours);
+    }
+}
+
+static void collectBeziers(const DynamicArray<SegmentDataArray> & _contours,
+                           BezierArray & _outCurves,
+                           CurveBoundsArray & _outBounds)
+{
+    for (const SegmentDataArray & segs : _contours)
+    {
+        for (Size i = 0; i < segs.count(); ++i)
+        {
+            const SegmentData & a = segs[i];
+            const SegmentData & b = segs[(i + 1) % segs.count()];
+            _outCurves.append(Bezier(a.position, a.handleOut, b.handleIn, b.position));
+            _outBounds.append({ _outCurves.last().bounds(), _outCurves.count() - 1 });
+        }
+    }
+}
+
+// adds the contours to the graph and splits their curves at the intersections.
+// _outSlotNodes receives the node of every intersection slot of the splits.
+static void addContours(const DynamicArray<SegmentDataArray> & _contours,
+                        DynamicArray<CurveSplitArray> & _splits,
+                        BooleanGraph & _graph,
+                        DynamicArray<Size> & _outSlotNodes)
+{
+    Float tMin = PaperConstants::curveTimeEpsilon();
+    Size curveIndex = 0;
+    for (const SegmentDataArray & segs : _contours)
+    {
+        Size base = _graph.nodes.count();
+        Size count = segs.count();
+        for (Size i = 0; i < count; ++i)
+        {
+            _graph.nodes.append(segs[i]);
+            _graph.next.append(base + (i + 1) % count);
+        }
+
+        for (Size i = 0; i < count; ++i, ++curveIndex)
+        {
+            CurveSplitArray & splits = _splits[curveIndex];
+            if (!splits.count())
+                continue;
+
+            std::sort(splits.begin(), splits.end(), [](const CurveSplit & _a, const CurveSplit & _b) {
+                return _a.parameter < _b.parameter;
+            });
+
+            Size startNode = base + i;
+            Size endNode = _graph.next[startNode];
+            Size current = startNode;
+            Bezier bez = _graph.bezier(startNode);
+            Float prevT = 0;
+            for (const CurveSplit & split : splits)
+            {
+                // intersections at (or very close to) existing nodes don't need a split
+                if (split.parameter < tMin)
+                    _outSlotNodes[split.slot] = startNode;
+                else if (split.parameter > 1 - tMin)
+                    _outSlotNodes[split.slot] = endNode;
+                else if (split.parameter - prevT < tMin)
+                    _outSlotNodes[split.slot] = current;
+                else
+                {
+                    // renormalize the parameter to the remaining part of the curve
+                    auto parts = bez.subdivide((split.parameter - prevT) / (1 - prevT));
+                    Size node = _graph.nodes.count();
+                    _graph.nodes[current].handleOut = parts.first.handleOne();
+                    _graph.next[current] = node;
+                    _graph.nodes.append({ parts.first.handleTwo(),
+                                          parts.first.positionTwo(),
+                                          parts.second.handleOne() });
+                    _graph.next.append(endNode);
+
+                    bez = parts.second;
+                    current = node;
+                    prevT = split.parameter;
+                    _outSlotNodes[split.slot] = node;
+                }
+            }
+            _graph.nodes[endNode].handleIn = bez.handleTwo();
+        }
+    }
+}
+
+static bool isInside(const Vec2f & _point, const MonoCurveLoopArray & _loops, WindingRule _rule)
+{
+    Int32 winding = BooleanOperations::winding(_point, _loops, false);
+    return _rule == WindingRule::EvenOdd ? winding & 1 : winding > 0;
+}
+
+static bool isInResult(BooleanOperation _op, bool _bInA, bool _bInB)
+{
+    switch (_op)
+    {
+    case BooleanOperation::Unite:
+        return _bInA || _bInB;
+    case BooleanOperation::Intersect:
+        return _bInA && _bInB;
+    case BooleanOperation::Subtract:
+        return _bInA && !_bInB;
+    case BooleanOperation::Exclude:
+        return _bInA != _bInB;
+    default:
+        STICK_ASSERT(false);
+        return false;
+    }
+}
+
+// nodes flagged in _skip are the shared pieces of the second operand, the ones of the first
+// operand decide for both.
+static void traceContours(const BooleanGraph & _graph,
+                          const DynamicArray<bool> & _skip,
+                          const Path * _a,
+                          const MonoCurveLoopArray & _loopsA,
+                          const Path * _b,
+                          const MonoCurveLoopArray & _loopsB,
+                          BooleanOperation _op,
+                          DynamicArray<SegmentDataArray> & _outContours)
+{
+    Allocator & alloc = _graph.nodes.allocator();
+
+    // find the curves on the boundary of the result and orient them so the result is on the
+    // side of their normal.
+    DynamicArray<BooleanEdge> edges(alloc);
+    for (Size i = 0; i < _graph.nodes.count(); ++i)
+    {
+        if (_skip[i])
+            continue;
+
+        Bezier bez = _graph.bezier(i);
+        Float length = bez.length();
+        if (length < PaperConstants::geometricEpsilon())
+            continue;
+
+        Vec2f center = bez.positionAt(0.5);
+        Vec2f offset = crunch::normalize(bez.normalAt(0.5)) *
+                       max(length * 1e-3f, PaperConstants::windingEpsilon() * 4.0f);
+        Vec2f a = center + offset;
+        Vec2f b = center - offset;
+        bool bPlus = isInResult(_op,
+                                isInside(a, _loopsA, _a->windingRule()),
+                                isInside(a, _loopsB, _b->windingRule()));
+        bool bMinus = isInResult(_op,
+                                 isInside(b, _loopsA, _a->windingRule()),
+                                 isInside(b, _loopsB, _b->windingRule()));
+        if (bPlus != bMinus)
+            edges.append({ i, bMinus });
+    }
+
+    // sort the edges by their start vertex, so we can quickly find the edges leaving a vertex
+    DynamicArray<Size> startVertices(alloc);
+    startVertices.resize(edges.count());
+    for (Size i = 0; i < edges.count(); ++i)
+        startVertices[i] = _graph.vertex(_graph.startNode(edges[i]));
+
+    DynamicArray<Size> order(alloc);
+    order.resize(edges.count());
+    for (Size i = 0; i < edges.count(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](Size _a, Size _b) {
+        return startVertices[_a] < startVertices[_b];
+    });
+
+    DynamicArray<bool> visited(alloc);
+    visited.resize(edges.count());
+    for (Size i = 0; i < edges.count(); ++i)
+        visited[i] = false;
+
+    DynamicArray<Size> loop(alloc);
+    for (Size first = 0; first < edges.count(); ++first)
+    {
+        if (visited[first])
+            continue;
+
+        loop.clear();
+        Size current = first;
+        bool bClosed = false;
+        while (true)
+        {
+            visited[current] = true;
+            loop.append(current);
+
+            Size end = _graph.endNode(edges[current]);
+            Size v = _graph.vertex(end);
+            if (v == startVertices[first])
+            {
+                bClosed = true;
+                break;
+            }
+
+            // pick the next edge leaving the vertex. If there are multiple (i.e. the operands
+            // touch), we prefer staying on the same contour.
+            auto it = std::lower_bound(order.begin(), order.end(), v, [&](Size _e, Size _v) {
+                return startVertices[_e] < _v;
+            });
+            Size next = -1;
+            for (; it != order.end() && startVertices[*it] == v; ++it)
+            {
+                if (visited[*it])
+                    continue;
+                if (_graph.startNode(edges[*it]) == end)
+                {
+                    next = *it;
+                    break;
+                }
+                if (next == (Size)-1)
+                    next = *it;
+            }
+
+            // dead end, this can happen for degenerate input. The curves are dropped.
+            if (next == (Size)-1)
+                break;
+            current = next;
+        }
+
+        if (!bClosed)
+            continue;
+
+        SegmentDataArray segs(alloc);
+        segs.reserve(loop.count());
+        Bezier prev = _graph.bezier(edges[loop.last()]);
+        for (Size e : loop)
+        {
+            Bezier bez = _graph.bezier(edges[e]);
+            segs.append({ prev.handleTwo(), bez.positionOne(), bez.handleOne() });
+            prev = bez;
+        }
+        _outContours.append(std::move(segs));
+    }
+}
+
+Path * BooleanOperations::apply(const Path * _a, const Path * _b, BooleanOperation _op)
+{
+    Document * doc = _a->document();
+    Allocator & alloc = doc->allocator();
+
+    // everything happens in the local space of _a
+    Mat32f transformA = Mat32f::identity();
+    Mat32f transformB = crunch::inverse(_a->absoluteTransform()) * _b->absoluteTransform();
+
+    DynamicArray<SegmentDataArray> contoursA(alloc);
+    DynamicArray<SegmentDataArray> contoursB(alloc);
+    collectContours(_a, transformA, contoursA);
+    collectContours(_b, transformB, contoursB);
+
+    MonoCurveLoopArray loopsA(alloc);
+    MonoCurveLoopArray loopsB(alloc);
+    monoCurves(_a, loopsA, &transformA);
+    monoCurves(_b, loopsB, &transformB);
+
+    // find the intersections between the operands
+    BezierArray curvesA(alloc);
+    BezierArray curvesB(alloc);
+    CurveBoundsArray boundsA(alloc);
+    CurveBoundsArray boundsB(alloc);
+    collectBeziers(contoursA, curvesA, boundsA);
+    collectBeziers(contoursB, curvesB, boundsB);
+
+    DynamicArray<CurveSplitArray> splitsA(alloc);
+    DynamicArray<CurveSplitArray> splitsB(alloc);
+    splitsA.resize(curvesA.count());
+    splitsB.resize(curvesB.count());
+    Size intersectionCount = 0;
+    CurveOverlap overlap;
+    DynamicArray<CurveOverlap> overlapsB(alloc);
+
+    CurvePairArray pairs(alloc);
+    Broadphase::overlappingPairs(boundsA, boundsB, pairs, PaperConstants::geometricEpsilon());
+    for (const CurvePair & pair : pairs)
+    {
+        if (addIntersections(curvesA[pair.a],
+                             splitsA[pair.a],
+                             curvesB[pair.b],
+                             splitsB[pair.b],
+                             intersectionCount,
+                             overlap))
+            overlapsB.append(overlap);
+    }
+
+    // self intersections of the operands, so every piece is either in- or outside of both. The
+    // joints of adjacent curves are found as well but end up at existing nodes.
+    BezierArray * curves[2] = { &curvesA, &curvesB };
+    DynamicArray<CurveSplitArray> * splits[2] = { &splitsA, &splitsB };
+    for (Size i = 0; i < 2; ++i)
+    {
+        pairs.clear();
+        SweepLine::overlappingPairs(*curves[i], pairs, PaperConstants::geometricEpsilon());
+        for (const CurvePair & pair : pairs)
+        {
+            addIntersections((*curves[i])[pair.a],
+                             (*splits[i])[pair.a],
+                             (*curves[i])[pair.b],
+                             (*splits[i])[pair.b],
+                             intersectionCount,
+                             overlap);
+        }
+    }
+
+    // split both operands at the intersections and connect them there
+    BooleanGraph graph(alloc);
+    DynamicArray<Size> slotNodes(alloc);
+    slotNodes.resize(intersectionCount * 2);
+    addContours(contoursA, splitsA, graph, slotNodes);
+    addContours(contoursB, splitsB, graph, slotNodes);
+
+    graph.vertices.resize(graph.nodes.count());
+    for (Size i = 0; i < graph.nodes.count(); ++i)
+        graph.vertices[i] = i;
+    for (Size i = 0; i < intersectionCount; ++i)
+        graph.join(slotNodes[i * 2], slotNodes[i * 2 + 1]);
+
+    // flag the nodes of the second operand that start a shared piece. The overlap can be split
+    // further by other intersections within it.
+    DynamicArray<bool> skip(alloc);
+    skip.resize(graph.nodes.count());
+    for (Size i = 0; i < graph.nodes.count(); ++i)
+        skip[i] = false;
+    for (const CurveOverlap & o : overlapsB)
+    {
+        Size end = slotNodes[o.endSlot];
+        for (Size n = slotNodes[o.startSlot], steps = 0; n != end && steps < graph.nodes.count();
+             n = graph.next[n], ++steps)
+            skip[n] = true;
+    }
+
+    DynamicArray<SegmentDataArray> contours(alloc);
+    if (_op == BooleanOperation::Divide)
+    {
+        // same as paper.js, divide results in the parts of _a outside and inside of _b
+        traceContours(graph, skip, _a, loopsA, _b, loopsB, BooleanOperation::Subtract, contours);
+        traceContours(graph, skip, _a, loopsA, _b, loopsB, BooleanOperation::Intersect, contours);
+    }
+    else
+        traceContours(graph, skip, _a, loopsA, _b, loopsB, _op, contours);
+
+    Path * ret = doc->createPath();
+    ret->setStyle(_a->stylePtr());
+    ret->setTransform(_a->transform());
+    ret->insertAbove(_a);
+    for (Size i = 0; i < contours.count(); ++i)
+    {
+        if (i == 0)
+            ret->swapSegments(contours[i], true);
+        else
+        {
+            Path * child = doc->createPath();
+            child->swapSegments(contours[i], true);
+            ret->addChild(child);
+        }
+    }
+
+    return ret;
+}
+
 } // namespace detail
 } // namespace paper
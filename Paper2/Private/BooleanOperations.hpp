@@ -2,6 +2,7 @@
 #define PAPER_PRIVATE_BOOLEANOPERATIONS_HPP
 
 #include <Paper2/BasicTypes.hpp>
+#include <Paper2/Constants.hpp>
 
 namespace paper
 {
@@ -17,12 +18,25 @@ struct STICK_LOCAL MonoCurve
 
 using MonoCurveArray = stick::DynamicArray<MonoCurve>;
 
+// buckets along the y axis, each holding the indices of the mono curves whose y range overlaps
+// it in ascending order. Bucket i holds curves[starts[i]] to curves[starts[i + 1]].
+struct STICK_LOCAL MonoCurveYIndex
+{
+    Float min;
+    Float max;
+    Float scale;
+    stick::DynamicArray<stick::UInt32> starts;
+    stick::DynamicArray<stick::UInt32> curves;
+};
+
 struct STICK_LOCAL MonoCurveLoop
 {
     Mat32f inverseTransform;
     bool bTransformed;
     MonoCurveArray monoCurves;
     MonoCurve last;
+    // only built for loops with enough curves to be worth it, empty otherwise.
+    MonoCurveYIndex yIndex;
 };
 
 using MonoCurveLoopArray = stick::DynamicArray<MonoCurveLoop>;
@@ -39,6 +53,10 @@ struct STICK_LOCAL BooleanOperations
     static stick::Int32 winding(const Vec2f & _point,
                                 const MonoCurveLoopArray & _loops,
                                 bool _bHorizontal);
+
+    // paper.js style boolean operation between _a and _b in the local space of _a. Returns a new
+    // path that is inserted above _a and takes over its style and transform.
+    static Path * apply(const Path * _a, const Path * _b, BooleanOperation _op);
 };
 } // namespace detail
 } // namespace paper
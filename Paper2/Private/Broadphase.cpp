@@ -0,0 +1,92 @@
+#include <Paper2/Private/Broadphase.hpp>
+
+#include <algorithm>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+static void sortByMinX(CurveBoundsArray & _bounds)
+{
+    std::sort(_bounds.begin(), _bounds.end(), [](const CurveBounds & _a, const CurveBounds & _b) {
+        return _a.bounds.min().x < _b.bounds.min().x;
+    });
+}
+
+static inline bool overlapsY(const Rect & _a, const Rect & _b, Float _epsilon)
+{
+    return _a.min().y <= _b.max().y + _epsilon && _b.min().y <= _a.max().y + _epsilon;
+}
+
+void Broadphase::overlappingPairs(CurveBoundsArray & _a,
+                                  CurveBoundsArray & _b,
+                                  CurvePairArray & _outPairs,
+                                  Float _epsilon)
+{
+    sortByMinX(_a);
+    sortByMinX(_b);
+
+    Size i = 0;
+    Size j = 0;
+    while (i < _a.count() && j < _b.count())
+    {
+        // the box with the smaller min x is tested against all boxes of the other set that
+        // start before it ends. Every overlapping pair is reported exactly once this way.
+        if (_a[i].bounds.min().x < _b[j].bounds.min().x)
+        {
+            const Rect & r = _a[i].bounds;
+            for (Size k = j; k < _b.count() && _b[k].bounds.min().x <= r.max().x + _epsilon; ++k)
+            {
+                if (overlapsY(r, _b[k].bounds, _epsilon))
+                    _outPairs.append({ _a[i].index, _b[k].index });
+            }
+            ++i;
+        }
+        else
+        {
+            const Rect & r = _b[j].bounds;
+            for (Size k = i; k < _a.count() && _a[k].bounds.min().x <= r.max().x + _epsilon; ++k)
+            {
+                if (overlapsY(r, _a[k].bounds, _epsilon))
+                    _outPairs.append({ _a[k].index, _b[j].index });
+            }
+            ++j;
+        }
+    }
+
+    sortPairs(_outPairs);
+}
+
+void Broadphase::overlappingPairs(CurveBoundsArray & _a, CurvePairArray & _outPairs, Float _epsilon)
+{
+    sortByMinX(_a);
+
+    for (Size i = 0; i < _a.count(); ++i)
+    {
+        const Rect & r = _a[i].bounds;
+        for (Size k = i + 1; k < _a.count() && _a[k].bounds.min().x <= r.max().x + _epsilon; ++k)
+        {
+            if (overlapsY(r, _a[k].bounds, _epsilon))
+            {
+                Size ia = _a[i].index;
+                Size ib = _a[k].index;
+                _outPairs.append(ia < ib ? CurvePair{ ia, ib } : CurvePair{ ib, ia });
+            }
+        }
+    }
+
+    sortPairs(_outPairs);
+}
+
+void Broadphase::sortPairs(CurvePairArray & _pairs)
+{
+    // we sort the pairs so that the results of the narrowphase come out in the same order
+    // as if every curve was tested against every other curve.
+    std::sort(_pairs.begin(), _pairs.end(), [](const CurvePair & _a, const CurvePair & _b) {
+        return _a.a < _b.a || (_a.a == _b.a && _a.b < _b.b);
+    });
+}
+} // namespace detail
+} // namespace paper
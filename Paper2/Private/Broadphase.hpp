@@ -0,0 +1,47 @@
+#ifndef PAPER_PRIVATE_BROADPHASE_HPP
+#define PAPER_PRIVATE_BROADPHASE_HPP
+
+#include <Paper2/BasicTypes.hpp>
+
+namespace paper
+{
+namespace detail
+{
+struct STICK_LOCAL CurveBounds
+{
+    Rect bounds;
+    Size index;
+};
+
+struct STICK_LOCAL CurvePair
+{
+    Size a;
+    Size b;
+};
+
+using CurveBoundsArray = stick::DynamicArray<CurveBounds>;
+using CurvePairArray = stick::DynamicArray<CurvePair>;
+
+// sort and sweep along the x axis to find the curves whose bounds overlap.
+// Only the pairs returned by these functions need to be handed to the (expensive)
+// bezier intersection code. NOTE: The input arrays get sorted in place.
+struct STICK_LOCAL Broadphase
+{
+    // finds all overlapping pairs between _a and _b. CurvePair::a refers to the index of the
+    // curve in _a, CurvePair::b to the index in _b. The pairs are sorted by a, then b.
+    static void overlappingPairs(CurveBoundsArray & _a,
+                                 CurveBoundsArray & _b,
+                                 CurvePairArray & _outPairs,
+                                 Float _epsilon);
+
+    // finds all overlapping pairs within _a. CurvePair::a is always smaller than CurvePair::b
+    // and the pairs are sorted by a, then b.
+    static void overlappingPairs(CurveBoundsArray & _a, CurvePairArray & _outPairs, Float _epsilon);
+
+    // sorts the pairs by a, then b.
+    static void sortPairs(CurvePairArray & _pairs);
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_BROADPHASE_HPP
@@ -0,0 +1,94 @@
+#ifndef PAPER_PRIVATE_DASHPATTERN_HPP
+#define PAPER_PRIVATE_DASHPATTERN_HPP
+
+#include <Paper2/BasicTypes.hpp>
+
+#include <cmath>
+
+namespace paper
+{
+namespace detail
+{
+// walks a dash array along a contour. Even dashes are drawn, odd ones are gaps. Like in SVG,
+// negative dash lengths or a pattern without length disable dashing and odd dash arrays are
+// repeated to get an even number of dashes.
+class STICK_LOCAL DashPattern
+{
+  public:
+    DashPattern(const DashArray & _dashArray, Float _dashOffset) :
+        m_dashArray(&_dashArray),
+        m_dashCount(_dashArray.count() % 2 ? _dashArray.count() * 2 : _dashArray.count()),
+        m_length(0),
+        m_dashOffset(_dashOffset),
+        m_dash(0),
+        m_remaining(0)
+    {
+        for (Float d : _dashArray)
+        {
+            if (d < 0)
+            {
+                m_length = 0;
+                break;
+            }
+            m_length += d;
+        }
+        if (_dashArray.count() % 2)
+            m_length *= 2;
+    }
+
+    bool isValid() const
+    {
+        return m_length > 0;
+    }
+
+    // moves to the dash offset, call this at the start of each contour.
+    void start()
+    {
+        const DashArray & dashes = *m_dashArray;
+        Float offset = std::fmod(m_dashOffset, m_length);
+        if (offset < 0)
+            offset += m_length;
+        m_dash = 0;
+        while (offset > 0 && offset >= dashes[m_dash % dashes.count()])
+        {
+            offset -= dashes[m_dash % dashes.count()];
+            m_dash = (m_dash + 1) % m_dashCount;
+        }
+        m_remaining = dashes[m_dash % dashes.count()] - offset;
+    }
+
+    bool isOn() const
+    {
+        return m_dash % 2 == 0;
+    }
+
+    // length left in the current dash or gap
+    Float remaining() const
+    {
+        return m_remaining;
+    }
+
+    // advances by _length within the current dash or gap.
+    void advance(Float _length)
+    {
+        m_remaining -= _length;
+    }
+
+    void next()
+    {
+        m_dash = (m_dash + 1) % m_dashCount;
+        m_remaining = (*m_dashArray)[m_dash % m_dashArray->count()];
+    }
+
+  private:
+    const DashArray * m_dashArray;
+    Size m_dashCount;
+    Float m_length;
+    Float m_dashOffset;
+    Size m_dash;
+    Float m_remaining;
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_DASHPATTERN_HPP
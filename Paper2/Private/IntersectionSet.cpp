@@ -0,0 +1,102 @@
+#include <Paper2/Private/IntersectionSet.hpp>
+
+#include <cmath>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+static const Size s_noIntersection = -1;
+
+// the cells are as big as the distance at which two locations become synonymous,
+// so we only need to look at the cell of an offset and its two neighbours.
+static inline Int64 offsetCell(Float _offset)
+{
+    return static_cast<Int64>(
+        std::floor(static_cast<Float64>(_offset) / PaperConstants::geometricEpsilon()));
+}
+
+static inline UInt64 cellKey(const Path * _path, Int64 _cell)
+{
+    // different paths might end up with the same key which is fine, as all candidates
+    // are checked with CurveLocation::isSynonymous anyways.
+    return static_cast<UInt64>(reinterpret_cast<uintptr_t>(_path)) * 0x9E3779B97F4A7C15ULL ^
+           static_cast<UInt64>(_cell);
+}
+
+IntersectionSet::IntersectionSet(IntersectionArray & _intersections) :
+    m_intersections(&_intersections),
+    m_next(_intersections.allocator())
+{
+    m_next.reserve(_intersections.count());
+    for (Size i = 0; i < _intersections.count(); ++i)
+        insert(i);
+}
+
+bool IntersectionSet::append(const CurveLocation & _location, const Vec2f & _position)
+{
+    if (_location.isValid())
+    {
+        const Path * path = _location.curve().path();
+        Float offset = _location.offset();
+        if (containsSynonym(_location, path, offset))
+            return false;
+
+        // for closed paths the start and end of the path are synonymous, too
+        Float length = path->length();
+        if (offset < PaperConstants::geometricEpsilon() &&
+            containsSynonym(_location, path, offset + length))
+            return false;
+        if (offset > length - PaperConstants::geometricEpsilon() &&
+            containsSynonym(_location, path, offset - length))
+            return false;
+    }
+
+    m_intersections->append({ _location, _position });
+    insert(m_intersections->count() - 1);
+    return true;
+}
+
+bool IntersectionSet::containsSynonym(const CurveLocation & _location,
+                                      const Path * _path,
+                                      Float _offset)
+{
+    Int64 cell = offsetCell(_offset);
+    for (Int64 c = cell - 1; c <= cell + 1; ++c)
+    {
+        auto it = m_cells.find(cellKey(_path, c));
+        if (it == m_cells.end())
+            continue;
+
+        for (Size i = it->value; i != s_noIntersection; i = m_next[i])
+        {
+            if ((*m_intersections)[i].location.isSynonymous(_location))
+                return true;
+        }
+    }
+    return false;
+}
+
+void IntersectionSet::insert(Size _index)
+{
+    m_next.append(s_noIntersection);
+
+    // invalid locations are never synonymous to anything
+    const CurveLocation & loc = (*m_intersections)[_index].location;
+    if (!loc.isValid())
+        return;
+
+    UInt64 key = cellKey(loc.curve().path(), offsetCell(loc.offset()));
+    auto it = m_cells.find(key);
+    if (it != m_cells.end())
+    {
+        m_next[_index] = it->value;
+        it->value = _index;
+    }
+    else
+        m_cells.insert(key, _index);
+}
+} // namespace detail
+} // namespace paper
@@ -0,0 +1,37 @@
+#ifndef PAPER_PRIVATE_INTERSECTIONSET_HPP
+#define PAPER_PRIVATE_INTERSECTIONSET_HPP
+
+#include <Paper2/Path.hpp>
+#include <Stick/HashMap.hpp>
+
+namespace paper
+{
+namespace detail
+{
+// Appends intersections to an IntersectionArray while skipping the ones that are synonymous
+// to an intersection that is already in it. The intersections are hashed by path and by a grid
+// over their offset along the path, so only the few intersections in the neighbouring cells need
+// to be compared.
+class STICK_LOCAL IntersectionSet
+{
+  public:
+    // _intersections might already contain intersections, they are added to the set.
+    IntersectionSet(IntersectionArray & _intersections);
+
+    // returns false if a synonymous intersection already exists.
+    bool append(const CurveLocation & _location, const Vec2f & _position);
+
+  private:
+    bool containsSynonym(const CurveLocation & _location, const Path * _path, Float _offset);
+
+    void insert(Size _index);
+
+    IntersectionArray * m_intersections;
+    // maps a cell to the last intersection inserted into it, m_next links to the one before.
+    stick::HashMap<UInt64, Size> m_cells;
+    stick::DynamicArray<Size> m_next;
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_INTERSECTIONSET_HPP
@@ -0,0 +1,138 @@
+#include <Paper2/Private/Parallel.hpp>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+// set for the workers and for the thread that currently hands out a task, neither can wait for
+// the workers without deadlocking.
+static thread_local bool s_bIsRunning = false;
+
+class STICK_LOCAL ThreadPool
+{
+  public:
+    ThreadPool() :
+        m_bStarted(false),
+        m_generation(0),
+        m_pending(0),
+        m_bStop(false),
+        m_task(nullptr),
+        m_userData(nullptr),
+        m_count(0),
+        m_chunk(0),
+        m_threadCount(0)
+    {
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStop = true;
+        }
+        m_wake.notify_all();
+        for (auto & t : m_threads)
+            t.join();
+    }
+
+    bool run(ParallelTask _task, void * _userData, Size _count, Size _threadCount)
+    {
+        if (s_bIsRunning)
+            return false;
+        std::unique_lock<std::mutex> busy(m_runMutex, std::try_to_lock);
+        if (!busy.owns_lock())
+            return false;
+
+        // the workers are started once for all hardware threads. Only this thread changes the
+        // generation, so it can be handed to them unlocked.
+        if (!m_bStarted)
+        {
+            Size workerCount = hardwareThreadCount() - 1;
+            m_threads.resize(workerCount);
+            for (Size i = 0; i < workerCount; ++i)
+                m_threads[i] = std::thread(&ThreadPool::work, this, i + 1, m_generation);
+            m_bStarted = true;
+        }
+
+        _threadCount = stick::min(_threadCount, m_threads.count() + 1);
+        if (_threadCount <= 1)
+            return false;
+
+        Size chunk = (_count + _threadCount - 1) / _threadCount;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = _task;
+            m_userData = _userData;
+            m_count = _count;
+            m_chunk = chunk;
+            m_threadCount = _threadCount;
+            m_pending = _threadCount - 1;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        s_bIsRunning = true;
+        _task(_userData, 0, 0, stick::min(chunk, _count));
+        s_bIsRunning = false;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_pending == 0; });
+        return true;
+    }
+
+  private:
+    void work(Size _index, Size _generation)
+    {
+        s_bIsRunning = true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [&]() { return m_bStop || m_generation != _generation; });
+            if (m_bStop)
+                return;
+            _generation = m_generation;
+
+            // fewer threads than workers were asked for
+            if (_index >= m_threadCount)
+                continue;
+
+            Size begin = stick::min(_index * m_chunk, m_count);
+            Size end = stick::min(begin + m_chunk, m_count);
+            ParallelTask task = m_task;
+            void * userData = m_userData;
+            lock.unlock();
+            task(userData, _index, begin, end);
+            lock.lock();
+            if (--m_pending == 0)
+                m_done.notify_one();
+        }
+    }
+
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    DynamicArray<std::thread> m_threads;
+    bool m_bStarted;
+    Size m_generation;
+    Size m_pending;
+    bool m_bStop;
+    ParallelTask m_task;
+    void * m_userData;
+    Size m_count;
+    Size m_chunk;
+    Size m_threadCount;
+};
+
+bool runOnWorkers(ParallelTask _task, void * _userData, Size _count, Size _threadCount)
+{
+    static ThreadPool s_pool;
+    return s_pool.run(_task, _userData, _count, _threadCount);
+}
+} // namespace detail
+} // namespace paper
@@ -0,0 +1,51 @@
+#ifndef PAPER_PRIVATE_PARALLEL_HPP
+#define PAPER_PRIVATE_PARALLEL_HPP
+
+#include <Paper2/BasicTypes.hpp>
+
+#include <thread>
+
+namespace paper
+{
+namespace detail
+{
+// number of threads to use for the parallel code paths.
+inline Size hardwareThreadCount()
+{
+    Size ret = std::thread::hardware_concurrency();
+    return ret ? ret : 1;
+}
+
+using ParallelTask = void (*)(void * _userData, Size _thread, Size _begin, Size _end);
+
+// runs _task for the ranges of parallelFor on the calling thread and the worker threads. The
+// workers are started on first use and live until the program ends, so their thread local
+// scratch memory is reused between calls. Returns false without running anything if the workers
+// are busy, i.e. when called from a task or from another thread at the same time.
+STICK_LOCAL bool runOnWorkers(ParallelTask _task, void * _userData, Size _count, Size _threadCount);
+
+// splits [0, _count) into _threadCount contiguous ranges and calls _fn(_thread, _begin, _end)
+// for each of them on its own thread. The calling thread handles the first range. If the
+// workers are busy, the calling thread handles everything as thread 0.
+// _fn must not touch any lazily cached data of the items (i.e. curve lengths or bounds)
+// unless it was computed before.
+template <class F>
+void parallelFor(Size _count, Size _threadCount, F _fn)
+{
+    if (_threadCount > _count)
+        _threadCount = _count;
+    if (_threadCount > 1)
+    {
+        ParallelTask task = [](void * _userData, Size _thread, Size _begin, Size _end) {
+            (*static_cast<F *>(_userData))(_thread, _begin, _end);
+        };
+        if (runOnWorkers(task, &_fn, _count, _threadCount))
+            return;
+    }
+
+    _fn(0, 0, _count);
+}
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_PARALLEL_HPP
@@ -8,15 +8,50 @@ namespace detail
 using namespace stick;
 using namespace crunch;
 
-PathFitter::PathFitter(Path * _p, Float64 _error, bool _bIgnoreClosed) :
+PathFitter::PathFitter(const Path * _p, Float64 _error, bool _bIgnoreClosed) :
     m_path(_p),
+    m_input(nullptr),
+    m_inputCount(0),
     m_error(_error),
     m_bIgnoreClosed(_bIgnoreClosed),
     m_newSegments(_p->segmentData().allocator()),
-    m_positions(_p->segmentData().allocator())
+    m_positions(nullptr),
+    m_curveEnds(nullptr)
 {
+}
+
+PathFitter::PathFitter(const Vec2f * _positions, Size _count, Float64 _error, Allocator & _alloc) :
+    m_path(nullptr),
+    m_input(_positions),
+    m_inputCount(_count),
+    m_error(_error),
+    m_bIgnoreClosed(true),
+    m_newSegments(_alloc),
+    m_positions(nullptr),
+    m_curveEnds(nullptr)
+{
+}
+
+void PathFitter::collectPositions(PositionArray & _outPositions) const
+{
+    if (!m_path)
+    {
+        _outPositions.reserve(m_inputCount);
+        for (Size i = 0; i < m_inputCount; ++i)
+        {
+            if (!i || m_input[i] != _outPositions.last())
+                _outPositions.append(m_input[i]);
+        }
+        return;
+    }
+
     auto & segs = m_path->segmentData();
-    m_positions.reserve(segs.count());
+    bool bClose = m_path->isClosed() && !m_bIgnoreClosed;
+    _outPositions.reserve(segs.count() + (bClose ? 2 : 0));
+
+    // a closed path starts with its last point so the fit wraps around smoothly
+    if (bClose && segs.count())
+        _outPositions.append(segs.last().position);
 
     Vec2f prev, point;
     prev = point = Vec2f(0);
@@ -26,41 +61,41 @@ PathFitter::PathFitter(Path * _p, Float64 _error, bool _bIgnoreClosed) :
         point = segs[i].position;
         if (i < 1 || prev != point)
         {
-            m_positions.append(point);
+            _outPositions.append(point);
             prev = point;
         }
     }
 
-    if (m_path->isClosed() && !m_bIgnoreClosed)
-    {
-        // this is kinda unefficient :( we should propably just insert that point
-        // first rather than shifting the whole array
-        Vec2f last = m_positions.last();
-        m_positions.insert(m_positions.begin(), last);
-        m_positions.append(m_positions[1]); // The point previously at index 0 is now 1.
-    }
+    if (bClose && segs.count())
+        _outPositions.append(_outPositions[1]); // The first point of the path is at index 1.
 }
 
-void PathFitter::fit()
+bool PathFitter::fit(SegmentDataArray & _outSegments)
 {
-    if (m_positions.count() > 0)
+    ScratchScope scratch;
+    PositionArray positions(scratch.allocator());
+    collectPositions(positions);
+    m_positions = &positions;
+    bool bResult = false;
+    if (positions.count() > 0)
     {
-        m_newSegments.append({ m_positions[0], m_positions[0], m_positions[0] });
+        m_newSegments.append({ positions[0], positions[0], positions[0] });
 
         // Size i = 0;
         // Size count = m_newSegments.count();
         // bool bReclose = false;
 
-        if (m_positions.count() > 1)
+        if (positions.count() > 1)
         {
             fitCubic(0,
-                     m_positions.count() - 1,
+                     positions.count() - 1,
                      // Left Tangent
-                     m_positions[1] - m_positions[0],
+                     positions[1] - positions[0],
                      // Right Tangent
-                     m_positions[m_positions.count() - 2] - m_positions[m_positions.count() - 1]);
+                     positions[positions.count() - 2] - positions[positions.count() - 1]);
 
-            if (m_path->isClosed())
+            // raw positions have no path and are always open
+            if (m_path && m_path->isClosed())
             {
                 // i++;
                 // if (count > 0)
@@ -90,8 +125,39 @@ void PathFitter::fit()
         //     m_newSegments[i].position, m_newSegments[i].handleIn,
         //     m_newSegments[i].handleOut, segs.count()));
         // }
-        m_path->swapSegments(m_newSegments, m_path->isClosed());
+        _outSegments.swap(m_newSegments);
+        bResult = true;
+    }
+    m_positions = nullptr;
+    return bResult;
+}
+
+void PathFitter::fit(const Vec2f & _tangent,
+                     SegmentDataArray & _outSegments,
+                     DynamicArray<Size> & _outCurveEnds)
+{
+    ScratchScope scratch;
+    PositionArray positions(scratch.allocator());
+    collectPositions(positions);
+    m_positions = &positions;
+    _outCurveEnds.clear();
+    m_curveEnds = &_outCurveEnds;
+    m_newSegments.clear();
+    if (positions.count() > 0)
+    {
+        m_newSegments.append({ positions[0], positions[0], positions[0] });
+        if (positions.count() > 1)
+        {
+            Vec2f tan1 = _tangent == Vec2f(0) ? positions[1] - positions[0] : _tangent;
+            fitCubic(0,
+                     positions.count() - 1,
+                     tan1,
+                     positions[positions.count() - 2] - positions[positions.count() - 1]);
+        }
     }
+    m_curveEnds = nullptr;
+    m_positions = nullptr;
+    _outSegments.swap(m_newSegments);
 }
 
 template<class T>
@@ -103,13 +169,14 @@ inline crunch::Vector2<T> normalizeSafe(const crunch::Vector2<T> & _vec)
 
 void PathFitter::fitCubic(Size _first, Size _last, const Vec2f & _tan1, const Vec2f & _tan2)
 {
+    const PositionArray & positions = *m_positions;
     // printf("FIRST %lu LAST %lu\n", _first, _last);
     // Use heuristic if region only has two points in it
     if (_last - _first == 1)
     {
         // printf("heuristic\n");
-        const Vec2f & pt1 = m_positions[_first];
-        const Vec2f & pt2 = m_positions[_last];
+        const Vec2f & pt1 = positions[_first];
+        const Vec2f & pt2 = positions[_last];
 
         STICK_ASSERT(!std::isnan(pt1.x));
         STICK_ASSERT(!std::isnan(pt1.y));
@@ -119,10 +186,14 @@ void PathFitter::fitCubic(Size _first, Size _last, const Vec2f & _tan1, const Ve
         Float64 dist = crunch::distance(pt1, pt2) / 3.0;
         STICK_ASSERT(!std::isnan(dist));
         addCurve(pt1, pt1 + normalizeSafe(_tan1) * dist, pt2 + normalizeSafe(_tan2) * dist, pt2);
+        if (m_curveEnds)
+            m_curveEnds->append(_last);
         return;
     }
 
-    DynamicArray<Float64> uPrime(m_newSegments.allocator());
+    // the parameters of each level of the recursion are released once it returns
+    ScratchScope scratch;
+    DynamicArray<Float64> uPrime(scratch.allocator());
     chordLengthParameterize(_first, _last, uPrime);
 
     // printf("NORMAL\n");
@@ -148,6 +219,8 @@ void PathFitter::fitCubic(Size _first, Size _last, const Vec2f & _tan1, const Ve
             // printf("ADDING CURVE\n");
             addCurve(
                 curve.positionOne(), curve.handleOne(), curve.handleTwo(), curve.positionTwo());
+            if (m_curveEnds)
+                m_curveEnds->append(_last);
             return;
         }
         split = max.index;
@@ -164,10 +237,10 @@ void PathFitter::fitCubic(Size _first, Size _last, const Vec2f & _tan1, const Ve
     }
 
     // Fitting failed -- split at max error point and fit recursively
-    // Vec2f v1 = m_positions[split - 1] - m_positions[split];
-    // Vec2f v2 = m_positions[split] - m_positions[split + 1];
+    // Vec2f v1 = positions[split - 1] - positions[split];
+    // Vec2f v2 = positions[split] - positions[split + 1];
     // Vec2f tanCenter = crunch::normalize((v1 + v2) * 0.5);
-    Vec2f tanCenter = m_positions[split - 1] - m_positions[split + 1];
+    Vec2f tanCenter = positions[split - 1] - positions[split + 1];
     fitCubic(_first, split, _tan1, tanCenter);
     fitCubic(split, _last, -tanCenter, _tan2);
 }
@@ -195,10 +268,11 @@ Bezier PathFitter::generateBezier(Size _first,
                                   const Vec2f & _tan1,
                                   const Vec2f & _tan2)
 {
+    const PositionArray & positions = *m_positions;
     static const Float64 s_epsilon = detail::PaperConstants::geometricEpsilon();
 
-    const Vec2f & pt1 = m_positions[_first];
-    const Vec2f & pt2 = m_positions[_last];
+    const Vec2f & pt1 = positions[_first];
+    const Vec2f & pt2 = positions[_last];
 
     Float64 c[2][2] = { { 0, 0 }, { 0, 0 } };
     Float64 x[2] = { 0, 0 };
@@ -214,7 +288,7 @@ Bezier PathFitter::generateBezier(Size _first,
         Float64 b3 = u * u * u;
         Vec2f a1 = normalizeSafe(_tan1) * b1;
         Vec2f a2 = normalizeSafe(_tan2) * b2;
-        Vec2f tmp = m_positions[_first + i];
+        Vec2f tmp = positions[_first + i];
         tmp -= pt1 * (b0 + b1);
         tmp -= pt2 * (b2 + b3);
 
@@ -329,9 +403,10 @@ bool PathFitter::reparameterize(Size _first,
                                 DynamicArray<Float64> & _u,
                                 const Bezier & _curve)
 {
+    const PositionArray & positions = *m_positions;
     for (Size i = _first; i <= _last; ++i)
     {
-        _u[i - _first] = findRoot(_curve, m_positions[i], _u[i - _first]);
+        _u[i - _first] = findRoot(_curve, positions[i], _u[i - _first]);
     }
 
     // Detect if the new parameterization has reordered the points.
@@ -374,13 +449,14 @@ void PathFitter::chordLengthParameterize(Size _first,
                                          Size _last,
                                          DynamicArray<Float64> & _outResult)
 {
+    const PositionArray & positions = *m_positions;
     Size size = _last - _first;
     _outResult.resize(size + 1);
     _outResult[0] = 0;
     for (Size i = _first + 1; i <= _last; ++i)
     {
         _outResult[i - _first] =
-            _outResult[i - _first - 1] + crunch::distance(m_positions[i], m_positions[i - 1]);
+            _outResult[i - _first - 1] + crunch::distance(positions[i], positions[i - 1]);
     }
     for (Size i = 1; i <= size; i++)
         _outResult[i] /= _outResult[size];
@@ -391,12 +467,13 @@ PathFitter::MaxError PathFitter::findMaxError(Size _first,
                                               const Bezier & _curve,
                                               const DynamicArray<Float64> & _u)
 {
+    const PositionArray & positions = *m_positions;
     Size index = crunch::floor((_last - _first + 1) / 2.0);
     Float64 maxDist = 0;
     for (Size i = _first + 1; i < _last; ++i)
     {
         Vec2f p = evaluate(3, _curve, _u[i - _first]);
-        Vec2f v = p - m_positions[i];
+        Vec2f v = p - positions[i];
         Float64 dist = v.x * v.x + v.y * v.y; // squared
         if (dist >= maxDist)
         {
@@ -2,6 +2,7 @@
 #define PAPER_PRIVATE_PATHFITTER_HPP
 
 #include <Paper2/Path.hpp>
+#include <Paper2/Private/ScratchAllocator.hpp>
 
 namespace paper
 {
@@ -24,9 +25,25 @@ class PathFitter
 
     using PositionArray = stick::DynamicArray<Vec2f>;
 
-    PathFitter(Path * _p, stick::Float64 _error, bool _bIgnoreClosed);
+    PathFitter(const Path * _p, stick::Float64 _error, bool _bIgnoreClosed);
 
-    void fit();
+    // fits positions that don't come from a path, see StreamingPathFitter. The segments are
+    // allocated with _alloc.
+    PathFitter(const Vec2f * _positions,
+               Size _count,
+               stick::Float64 _error,
+               stick::Allocator & _alloc);
+
+    // the fitted segments replace _outSegments, the path is not changed. Returns false if there
+    // was nothing to fit.
+    bool fit(SegmentDataArray & _outSegments);
+
+    // fits the positions as an open curve leaving the first position in direction of _tangent,
+    // or towards the second position if it is zero. The fitted segments replace _outSegments,
+    // _outCurveEnds receives the index of the position each curve ends at.
+    void fit(const Vec2f & _tangent,
+             SegmentDataArray & _outSegments,
+             stick::DynamicArray<Size> & _outCurveEnds);
 
     void fitCubic(Size _first, Size _last, const Vec2f & _tan1, const Vec2f & _tan2);
 
@@ -66,11 +83,19 @@ class PathFitter
                           const stick::DynamicArray<stick::Float64> & _u);
 
   private:
-    Path * m_path;
+    // copies the positions to fit to _outPositions, skipping adjacent duplicates.
+    void collectPositions(PositionArray & _outPositions) const;
+
+    const Path * m_path;
+    const Vec2f * m_input;
+    Size m_inputCount;
     Float m_error;
     bool m_bIgnoreClosed;
     SegmentDataArray m_newSegments;
-    PositionArray m_positions;
+    // the positions and parameters are scratch memory of the fit call, m_newSegments ends up in
+    // the path and comes from its allocator.
+    const PositionArray * m_positions;
+    stick::DynamicArray<Size> * m_curveEnds;
 };
 } // namespace detail
 } // namespace paper
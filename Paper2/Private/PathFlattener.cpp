@@ -7,9 +7,6 @@ namespace paper
 {
 namespace detail
 {
-//@TODO: This is by no means a very fast solution, but a simple one.
-// A better approach might be to get rid of the recursion.
-
 bool PathFlattener::isFlatEnough(const Bezier & _curve, Float _tolerance)
 {
     if (_curve.isLinear())
@@ -25,6 +22,36 @@ bool PathFlattener::isFlatEnough(const Bezier & _curve, Float _tolerance)
     return val < 10.0 * _tolerance * _tolerance;
 }
 
+static void appendPosition(const Vec2f & _start,
+                           const Vec2f & _end,
+                           bool _bCurveEnd,
+                           PathFlattener::PositionArray & _outPositions,
+                           PathFlattener::JoinArray * _outJoins,
+                           Float _minDistSquared,
+                           bool _bIsClosed,
+                           bool _bLastCurve)
+{
+    if (_outPositions.count())
+    {
+        if (crunch::distanceSquared(_end, _outPositions.last()) >= _minDistSquared)
+        {
+            _outPositions.append(_end);
+            if (_outJoins)
+                _outJoins->append(_bCurveEnd && (_bIsClosed || !_bLastCurve));
+        }
+    }
+    else
+    {
+        // for the first curve we also add its first segment
+        _outPositions.append(_start);
+        if (_outJoins)
+            _outJoins->append(false);
+        _outPositions.append(_end);
+        if (_outJoins)
+            _outJoins->append(_bCurveEnd && !_bLastCurve);
+    }
+}
+
 void PathFlattener::flatten(const Path * _path,
                             PositionArray & _outPositions,
                             JoinArray * _outJoins,
@@ -34,14 +61,11 @@ void PathFlattener::flatten(const Path * _path,
 {
     for (Size i = 0; i < _path->curveCount(); ++i)
     {
-        Curve c = _path->curve(i);
-        flattenCurve(c.bezier(),
-                     c.bezier(),
+        flattenCurve(_path->curve(i).bezier(),
                      _outPositions,
                      _outJoins,
                      _angleTolerance,
                      _minDistance,
-                     0,
                      _maxRecursionDepth,
                      _path->isClosed(),
                      i == _path->curveCount() - 1);
@@ -49,72 +73,86 @@ void PathFlattener::flatten(const Path * _path,
 }
 
 void PathFlattener::flattenCurve(const Bezier & _curve,
-                                 const Bezier & _initialCurve,
                                  PositionArray & _outPositions,
                                  JoinArray * _outJoins,
                                  Float _angleTolerance,
                                  Float _minDistance,
-                                 stick::Size _recursionDepth,
                                  stick::Size _maxRecursionDepth,
                                  bool _bIsClosed,
                                  bool _bLastCurve)
 {
-    if (_recursionDepth < _maxRecursionDepth && !isFlatEnough(_curve, _angleTolerance))
+    Float minDistSquared = _minDistance * _minDistance;
+    const Vec2f & p0 = _curve.positionOne();
+    const Vec2f & p3 = _curve.positionTwo();
+
+    if (_curve.isLinear())
     {
-        Bezier::Pair curves = _curve.subdivide(0.5);
-        flattenCurve(curves.first,
-                     _initialCurve,
-                     _outPositions,
-                     _outJoins,
-                     _angleTolerance,
-                     _minDistance,
-                     _recursionDepth + 1,
-                     _maxRecursionDepth,
-                     _bIsClosed,
-                     _bLastCurve);
-        flattenCurve(curves.second,
-                     _initialCurve,
-                     _outPositions,
-                     _outJoins,
-                     _angleTolerance,
-                     _minDistance,
-                     _recursionDepth + 1,
-                     _maxRecursionDepth,
-                     _bIsClosed,
-                     _bLastCurve);
+        appendPosition(
+            p0, p3, true, _outPositions, _outJoins, minDistSquared, _bIsClosed, _bLastCurve);
+        return;
     }
-    else
+
+    // the curve in power basis, B(t) = ((c3 * t + c2) * t + c1) * t + c0
+    const Vec2f & p1 = _curve.handleOne();
+    const Vec2f & p2 = _curve.handleTwo();
+    Vec2f c1 = (p1 - p0) * 3.0f;
+    Vec2f c2 = (p0 - p1 * 2.0f + p2) * 3.0f;
+    Vec2f c3 = p3 - p0 + (p1 - p2) * 3.0f;
+
+    // isFlatEnough of the piece [t, t + h] without splitting it off. Its vectors u and v are
+    // -(h^2 / 2) * B''(t) - (h^3 / 6) * B''' and -(h^2 / 2) * B''(t + h) + (h^3 / 6) * B'''.
+    Float tolerance = 10.0f * _angleTolerance * _angleTolerance;
+    auto isPieceFlatEnough = [&](Float64 _t, Float64 _h) {
+        Float h2 = static_cast<Float>(_h * _h);
+        Float h3 = static_cast<Float>(_h * _h * _h);
+        Vec2f u = (c3 * static_cast<Float>(3.0 * _t) + c2) * h2 + c3 * h3;
+        Vec2f v = (c3 * static_cast<Float>(3.0 * (_t + _h)) + c2) * h2 - c3 * h3;
+        return std::max(u.x * u.x, v.x * v.x) + std::max(u.y * u.y, v.y * v.y) < tolerance;
+    };
+
+    // walk the leaves of the subdivision tree in order. index is the position of the current
+    // piece among the pieces of its depth, so its lowest bit tells if it is a second half. The
+    // pieces start at dyadic fractions, which doubles represent exactly up to the clamped depth.
+    Size maxDepth = stick::min(_maxRecursionDepth, (Size)52);
+    Size depth = 0;
+    UInt64 index = 0;
+    Float64 t = 0;
+    Float64 h = 1;
+    Vec2f start = p0;
+    while (true)
     {
-        Float minDistSquared = _minDistance * _minDistance;
-        if (_outPositions.count())
+        if (depth < maxDepth && !isPieceFlatEnough(t, h))
         {
-            if (crunch::distanceSquared(_curve.positionTwo(), _outPositions.last()) >=
-                minDistSquared)
-            {
-                _outPositions.append(_curve.positionTwo());
-                if (_outJoins)
-                {
-                    if (_bIsClosed)
-                        _outJoins->append(_curve.positionTwo() == _initialCurve.positionTwo());
-                    else
-                        _outJoins->append(_curve.positionTwo() == _initialCurve.positionTwo() &&
-                                          !_bLastCurve);
-                }
-            }
+            ++depth;
+            index <<= 1;
+            h *= 0.5;
+            continue;
         }
-        else
+
+        t += h;
+        bool bCurveEnd = t == 1.0;
+        Float tf = static_cast<Float>(t);
+        Vec2f end = bCurveEnd ? p3 : ((c3 * tf + c2) * tf + c1) * tf + p0;
+        appendPosition(start,
+                       end,
+                       bCurveEnd,
+                       _outPositions,
+                       _outJoins,
+                       minDistSquared,
+                       _bIsClosed,
+                       _bLastCurve);
+        if (bCurveEnd)
+            break;
+        start = end;
+
+        // second halves complete their parent, move up until the next piece is a second half
+        while (index & 1)
         {
-            // for the first curve we also add its first segment
-            _outPositions.append(_curve.positionOne());
-            if (_outJoins)
-                _outJoins->append(false);
-            _outPositions.append(_curve.positionTwo());
-            if (_outJoins)
-            {
-                _outJoins->append(_curve.positionTwo() == _initialCurve.positionTwo() &&
-                                  !_bLastCurve);
-            }
+            index >>= 1;
+            --depth;
+            h *= 2.0;
         }
+        ++index;
     }
 }
 } // namespace detail
@@ -25,13 +25,14 @@ struct STICK_LOCAL PathFlattener
                         Float _minDistance,
                         Size _maxRecursionDepth);
 
+    // the curve is split in halves until the pieces are flat enough, just like recursive
+    // subdivision would. The flatness of each piece is computed directly from the polynomial of
+    // the curve, so neither the pieces nor a stack are needed.
     static void flattenCurve(const Bezier & _curve,
-                             const Bezier & _initialCurve,
                              PositionArray & _outPositions,
                              JoinArray * _outJoins,
                              Float _angleTolerance,
                              Float _minDistance,
-                             Size _recursionDepth,
                              Size _maxRecursionDepth,
                              bool _bIsClosed,
                              bool _bLastCurve);
@@ -0,0 +1,376 @@
+#include <Paper2/Private/Broadphase.hpp>
+#include <Paper2/Private/IntersectionSet.hpp>
+#include <Paper2/Private/Parallel.hpp>
+#include <Paper2/Private/PathIntersections.hpp>
+#include <Paper2/Private/ScratchAllocator.hpp>
+#include <Paper2/Private/SweepLine.hpp>
+#include <Paper2/Private/TransformedSegmentView.hpp>
+
+#include <algorithm>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+static inline bool isAdjacentCurve(Size _a, Size _b, Size _curveCount, bool _bIsClosed)
+{
+    if (_b == _a + 1 || (_bIsClosed && _a == 0 && _b == _curveCount - 1))
+        return true;
+    return false;
+}
+
+// collects the bounds of all curves for the broadphase. If the segments are not transformed,
+// we use the cached curve bounds of the path.
+static inline void collectCurveBounds(const Path * _path,
+                                      const TransformedSegmentView & _segments,
+                                      CurveBoundsArray & _outBounds)
+{
+    Size count = _segments.curveCount();
+    _outBounds.reserve(count);
+    for (Size i = 0; i < count; ++i)
+    {
+        _outBounds.append({ _segments.isTransformed() ? _segments.curveBezier(i).bounds()
+                                                      : _path->curve(i).bounds(),
+                            i });
+    }
+}
+
+// runs the narrowphase for curve _i of _pathA and curve _j of _pathB. If both curves are on the
+// same path, _i has to be smaller than _j.
+static inline void addCurveIntersections(const Path * _pathA,
+                                         Size _i,
+                                         const Bezier & _a,
+                                         const Path * _pathB,
+                                         Size _j,
+                                         const Bezier & _b,
+                                         IntersectionSet & _intersections)
+{
+    auto intersections = _a.intersections(_b);
+    for (Int32 z = 0; z < intersections.count; ++z)
+    {
+        bool bAdd = true;
+        // for self intersection we only add the intersection if its not where
+        // adjacent curves connect.
+        if (_pathA == _pathB)
+        {
+            if (isAdjacentCurve(_i, _j, _pathA->curveCount(), _pathA->isClosed()))
+            {
+                if ((crunch::isClose(intersections.values[z].parameterOne,
+                                     1.0f,
+                                     detail::PaperConstants::curveTimeEpsilon()) &&
+                     crunch::isClose(intersections.values[z].parameterTwo,
+                                     0.0f,
+                                     detail::PaperConstants::curveTimeEpsilon())) ||
+                    // this case can only happen for closed paths where the first curve
+                    // meets the last one
+                    (_pathA->isClosed() &&
+                     crunch::isClose(intersections.values[z].parameterOne,
+                                     0.0f,
+                                     detail::PaperConstants::curveTimeEpsilon()) &&
+                     crunch::isClose(intersections.values[z].parameterTwo,
+                                     1.0f,
+                                     detail::PaperConstants::curveTimeEpsilon())))
+                {
+                    bAdd = false;
+                }
+            }
+        }
+
+        // the set makes sure we don't add an intersection twice. This can happen if the
+        // intersection is located between two adjacent curves of the path.
+        if (bAdd)
+        {
+            _intersections.append(
+                _pathA->curve(_i).curveLocationAtParameter(intersections.values[z].parameterOne),
+                intersections.values[z].position);
+        }
+    }
+}
+
+static inline void intersectPaths(const Path * _self,
+                                  const Path * _other,
+                                  IntersectionSet & _intersections,
+                                  const Mat32f * _transformSelf,
+                                  const Mat32f * _transformOther)
+{
+    bool bSelf = _self == _other;
+
+    // the segments are transformed on the fly, so no temporary copies are needed.
+    TransformedSegmentView segmentsA(_self, _transformSelf);
+    TransformedSegmentView segmentsB(_other, bSelf ? _transformSelf : _transformOther);
+
+    // broadphase: only curves with overlapping bounds are handed to the bezier intersection
+    // code below.
+    ScratchScope scratch;
+    Allocator & alloc = scratch.allocator();
+    CurveBoundsArray boundsA(alloc);
+    CurvePairArray pairs(alloc);
+    collectCurveBounds(_self, segmentsA, boundsA);
+    if (bSelf)
+    {
+        Broadphase::overlappingPairs(boundsA, pairs, PaperConstants::geometricEpsilon());
+    }
+    else
+    {
+        CurveBoundsArray boundsB(alloc);
+        collectCurveBounds(_other, segmentsB, boundsB);
+        Broadphase::overlappingPairs(boundsA, boundsB, pairs, PaperConstants::geometricEpsilon());
+    }
+
+    Bezier a, b;
+    Size lastA = -1;
+    for (const CurvePair & pair : pairs)
+    {
+        Size i = pair.a;
+        Size j = pair.b;
+
+        // pairs are sorted by a, so we only need to rebuild a if it changed.
+        if (i != lastA)
+        {
+            a = segmentsA.curveBezier(i);
+            lastA = i;
+        }
+        b = segmentsB.curveBezier(j);
+
+        addCurveIntersections(_self, i, a, _other, j, b, _intersections);
+    }
+}
+
+// helper to recursively intersect paths and its children (compound path)
+static inline void recursivelyIntersect(const Path * _self,
+                                        const Path * _other,
+                                        IntersectionSet & _intersections,
+                                        const Mat32f * _transformSelf,
+                                        const Mat32f * _transformOther)
+{
+    intersectPaths(_self, _other, _intersections, _transformSelf, _transformOther);
+
+    for (Item * c : _other->children())
+        recursivelyIntersect(
+            _self, static_cast<Path *>(c), _intersections, _transformSelf, _transformOther);
+}
+
+static inline void flattenPathChildren(const Path * _path,
+                                       stick::DynamicArray<const Path *> & _outPaths)
+{
+    _outPaths.append(_path);
+    for (Item * c : _path->children())
+        flattenPathChildren(static_cast<Path *>(c), _outPaths);
+}
+
+struct ContourCurve
+{
+    Size path;
+    Size curve;
+};
+
+// self intersection of a flat list of contours. All curves of all contours go through one sweep
+// line, so intersections within a contour and between contours are found in the same pass.
+static inline void intersectContours(const stick::DynamicArray<const Path *> & _paths,
+                                     IntersectionSet & _intersections,
+                                     const Mat32f * _transform)
+{
+    ScratchScope scratch;
+    Allocator & alloc = scratch.allocator();
+    BezierArray curves(alloc);
+    stick::DynamicArray<ContourCurve> contourCurves(alloc);
+    for (Size i = 0; i < _paths.count(); ++i)
+    {
+        TransformedSegmentView segments(_paths[i], _transform);
+        for (Size j = 0; j < segments.curveCount(); ++j)
+        {
+            curves.append(segments.curveBezier(j));
+            contourCurves.append({ i, j });
+        }
+    }
+
+    CurvePairArray pairs(alloc);
+    SweepLine::overlappingPairs(curves, pairs, PaperConstants::geometricEpsilon());
+
+    // curves are collected contour by contour, so for pairs within the same contour the curve
+    // index of a is always smaller than the one of b.
+    for (const CurvePair & pair : pairs)
+    {
+        const ContourCurve & a = contourCurves[pair.a];
+        const ContourCurve & b = contourCurves[pair.b];
+        addCurveIntersections(_paths[a.path],
+                              a.curve,
+                              curves[pair.a],
+                              _paths[b.path],
+                              b.curve,
+                              curves[pair.b],
+                              _intersections);
+    }
+}
+
+void PathIntersections::intersect(const Path * _self,
+                                  const Path * _other,
+                                  IntersectionArray & _outIntersections,
+                                  const Mat32f * _transformSelf,
+                                  const Mat32f * _transformOther)
+{
+    // all nested children of _self, in the same order as intersectAll visits them
+    ScratchScope scratch;
+    IntersectionSet intersections(_outIntersections);
+    DynamicArray<const Path *> paths(scratch.allocator());
+    flattenPathChildren(_self, paths);
+    for (const Path * p : paths)
+        recursivelyIntersect(p, _other, intersections, _transformSelf, _transformOther);
+}
+
+void PathIntersections::intersectSelf(const Path * _path,
+                                      IntersectionArray & _outIntersections,
+                                      const Mat32f * _transform)
+{
+    // for self intersection we create a flat list of all nested paths to avoid double
+    // comparisons
+    ScratchScope scratch;
+    IntersectionSet intersections(_outIntersections);
+    DynamicArray<const Path *> paths(scratch.allocator());
+    paths.reserve(16);
+    flattenPathChildren(_path, paths);
+    intersectContours(paths, intersections, _transform);
+}
+
+struct OwnedCurve
+{
+    // index of the path passed to intersectAll that the curve belongs to
+    Size owner;
+    // index of the path among the owner and its nested children
+    Size contour;
+    const Path * path;
+    Size curve;
+};
+
+struct CurveHit
+{
+    Size curve;
+    Size otherCurve;
+    Float parameter;
+    Vec2f position;
+};
+
+using CurveHitArray = DynamicArray<CurveHit>;
+
+void PathIntersections::intersectAll(const Path * const * _paths,
+                                     Size _count,
+                                     IntersectionArray & _outIntersections,
+                                     bool _bMultithreaded)
+{
+    // the worker threads append to threadHits, so that has to come from the regular allocator.
+    // Everything else is only touched by this thread.
+    Allocator & alloc = _outIntersections.allocator();
+    ScratchScope scratch;
+    Allocator & scratchAlloc = scratch.allocator();
+    BezierArray curves(scratchAlloc);
+    DynamicArray<OwnedCurve> ownedCurves(scratchAlloc);
+    CurveBoundsArray bounds(scratchAlloc);
+    DynamicArray<const Path *> contours(scratchAlloc);
+
+    // every path is transformed exactly once and all curves of all paths go into the same
+    // broadphase.
+    for (Size i = 0; i < _count; ++i)
+    {
+        const Mat32f & transform = _paths[i]->absoluteTransform();
+        contours.clear();
+        flattenPathChildren(_paths[i], contours);
+        for (Size k = 0; k < contours.count(); ++k)
+        {
+            TransformedSegmentView segments(contours[k], &transform);
+            for (Size j = 0; j < segments.curveCount(); ++j)
+            {
+                curves.append(segments.curveBezier(j));
+                bounds.append({ curves.last().bounds(), curves.count() - 1 });
+                ownedCurves.append({ i, k, contours[k], j });
+            }
+        }
+    }
+
+    CurvePairArray pairs(scratchAlloc);
+    Broadphase::overlappingPairs(bounds, pairs, PaperConstants::geometricEpsilon());
+
+    // only keep the pairs between different paths
+    Size pairCount = 0;
+    for (const CurvePair & pair : pairs)
+    {
+        if (ownedCurves[pair.a].owner != ownedCurves[pair.b].owner)
+            pairs[pairCount++] = pair;
+    }
+    pairs.resize(pairCount);
+
+    // the narrowphase only reads the beziers collected above, so the pairs can be split up
+    // between threads. Everything that touches the caches of the paths happens afterwards.
+    Size threadCount = _bMultithreaded ? hardwareThreadCount() : 1;
+    DynamicArray<CurveHitArray> threadHits(alloc);
+    threadHits.reserve(threadCount);
+    for (Size i = 0; i < threadCount; ++i)
+        threadHits.append(CurveHitArray(alloc));
+    parallelFor(pairs.count(), threadCount, [&](Size _thread, Size _begin, Size _end) {
+        CurveHitArray & hits = threadHits[_thread];
+        for (Size i = _begin; i < _end; ++i)
+        {
+            const CurvePair & pair = pairs[i];
+            auto intersections = curves[pair.a].intersections(curves[pair.b]);
+            for (Int32 z = 0; z < intersections.count; ++z)
+            {
+                hits.append({ pair.a,
+                              pair.b,
+                              intersections.values[z].parameterOne,
+                              intersections.values[z].position });
+            }
+        }
+    });
+
+    // each thread got a contiguous range of pairs, so this keeps the order of the pairs.
+    CurveHitArray hits(scratchAlloc);
+    for (const CurveHitArray & th : threadHits)
+        for (const CurveHit & hit : th)
+            hits.append(hit);
+
+    // the pairwise api goes through the paths, then the nested paths of both sides and then the
+    // pairs of curves of two nested paths. The pairs are sorted by curve already, but not by
+    // nested path of the other side. The hits of one pair keep their order.
+    std::stable_sort(hits.begin(), hits.end(), [&](const CurveHit & _a, const CurveHit & _b) {
+        const OwnedCurve & a = ownedCurves[_a.curve];
+        const OwnedCurve & b = ownedCurves[_b.curve];
+        const OwnedCurve & otherA = ownedCurves[_a.otherCurve];
+        const OwnedCurve & otherB = ownedCurves[_b.otherCurve];
+        if (a.owner != b.owner)
+            return a.owner < b.owner;
+        if (otherA.owner != otherB.owner)
+            return otherA.owner < otherB.owner;
+        if (a.contour != b.contour)
+            return a.contour < b.contour;
+        if (otherA.contour != otherB.contour)
+            return otherA.contour < otherB.contour;
+        if (_a.curve != _b.curve)
+            return _a.curve < _b.curve;
+        return _a.otherCurve < _b.otherCurve;
+    });
+
+    // duplicates are removed per pair of paths, just like the pairwise api does.
+    IntersectionArray group(scratchAlloc);
+    for (Size i = 0; i < hits.count();)
+    {
+        Size owner = ownedCurves[hits[i].curve].owner;
+        Size otherOwner = ownedCurves[hits[i].otherCurve].owner;
+
+        group.clear();
+        IntersectionSet intersections(group);
+        for (; i < hits.count() && ownedCurves[hits[i].curve].owner == owner &&
+               ownedCurves[hits[i].otherCurve].owner == otherOwner;
+             ++i)
+        {
+            const OwnedCurve & c = ownedCurves[hits[i].curve];
+            intersections.append(c.path->curve(c.curve).curveLocationAtParameter(hits[i].parameter),
+                                 hits[i].position);
+        }
+
+        for (const Intersection & isec : group)
+            _outIntersections.append(isec);
+    }
+}
+} // namespace detail
+} // namespace paper
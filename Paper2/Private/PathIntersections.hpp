@@ -0,0 +1,34 @@
+#ifndef PAPER_PRIVATE_PATHINTERSECTIONS_HPP
+#define PAPER_PRIVATE_PATHINTERSECTIONS_HPP
+
+#include <Paper2/Path.hpp>
+
+namespace paper
+{
+namespace detail
+{
+struct STICK_LOCAL PathIntersections
+{
+    // intersections between _self and its nested children and _other and its nested children.
+    static void intersect(const Path * _self,
+                          const Path * _other,
+                          IntersectionArray & _outIntersections,
+                          const Mat32f * _transformSelf,
+                          const Mat32f * _transformOther);
+
+    // self intersections of _path including the intersections between its children.
+    static void intersectSelf(const Path * _path,
+                              IntersectionArray & _outIntersections,
+                              const Mat32f * _transform);
+
+    // intersections between all pairs of _paths in document space. The result is the same as
+    // calling _paths[i]->intersections(_paths[j]) for all i < j and appending the results.
+    static void intersectAll(const Path * const * _paths,
+                             Size _count,
+                             IntersectionArray & _outIntersections,
+                             bool _bMultithreaded);
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_PATHINTERSECTIONS_HPP
@@ -0,0 +1,90 @@
+#include <Paper2/Private/ScratchAllocator.hpp>
+
+#include <cstdint>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+static inline uintptr_t alignUp(uintptr_t _address, Size _alignment)
+{
+    return (_address + _alignment - 1) & ~(static_cast<uintptr_t>(_alignment) - 1);
+}
+
+ScratchAllocator::ScratchAllocator(Size _chunkSize) :
+    m_chunkSize(_chunkSize),
+    m_chunks(defaultAllocator()),
+    m_chunk(0),
+    m_offset(0)
+{
+}
+
+ScratchAllocator::~ScratchAllocator()
+{
+    for (const Block & chunk : m_chunks)
+        defaultAllocator().deallocate(chunk);
+}
+
+Block ScratchAllocator::allocate(Size _byteCount, Size _alignment)
+{
+    if (m_chunks.count())
+    {
+        const Block & chunk = m_chunks[m_chunk];
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk.ptr);
+        uintptr_t ptr = alignUp(base + m_offset, _alignment);
+        if (ptr + _byteCount <= base + chunk.byteCount)
+        {
+            m_offset = ptr + _byteCount - base;
+            return { reinterpret_cast<void *>(ptr), _byteCount };
+        }
+    }
+
+    // the current chunk is full. Use the next one if it is big enough, otherwise put a new chunk
+    // right after the current one so the chunks stay in the order they are used in.
+    Size needed = _byteCount + _alignment;
+    Size next = m_chunks.count() ? m_chunk + 1 : 0;
+    if (next >= m_chunks.count() || m_chunks[next].byteCount < needed)
+    {
+        Block chunk = defaultAllocator().allocate(stick::max(m_chunkSize, needed), 16);
+        m_chunks.insert(m_chunks.begin() + next, chunk);
+    }
+
+    m_chunk = next;
+    uintptr_t base = reinterpret_cast<uintptr_t>(m_chunks[m_chunk].ptr);
+    uintptr_t ptr = alignUp(base, _alignment);
+    m_offset = ptr + _byteCount - base;
+    return { reinterpret_cast<void *>(ptr), _byteCount };
+}
+
+void ScratchAllocator::deallocate(const Block & _block)
+{
+    // only the last allocation can be given back right away, i.e. a temporary array that is
+    // destroyed before anything else was allocated after it.
+    if (!m_chunks.count())
+        return;
+    uintptr_t base = reinterpret_cast<uintptr_t>(m_chunks[m_chunk].ptr);
+    uintptr_t ptr = reinterpret_cast<uintptr_t>(_block.ptr);
+    if (ptr >= base && ptr + _block.byteCount == base + m_offset)
+        m_offset = ptr - base;
+}
+
+ScratchAllocator::Marker ScratchAllocator::marker() const
+{
+    return { m_chunk, m_offset };
+}
+
+void ScratchAllocator::rewind(const Marker & _marker)
+{
+    m_chunk = _marker.chunk;
+    m_offset = _marker.offset;
+}
+
+ScratchAllocator & scratchAllocator()
+{
+    static thread_local ScratchAllocator s_alloc;
+    return s_alloc;
+}
+} // namespace detail
+} // namespace paper
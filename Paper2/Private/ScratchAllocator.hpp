@@ -0,0 +1,77 @@
+#ifndef PAPER_PRIVATE_SCRATCHALLOCATOR_HPP
+#define PAPER_PRIVATE_SCRATCHALLOCATOR_HPP
+
+#include <Paper2/BasicTypes.hpp>
+#include <Stick/Allocator.hpp>
+
+namespace paper
+{
+namespace detail
+{
+// bump allocator for short lived temporaries of the geometry code. Memory is handed out from
+// chunks that are kept around once allocated, so after warming up a query does not hit the
+// general purpose allocator at all. deallocate only gives memory back if it was the last
+// allocation, everything else is released in one go when the owning ScratchScope ends.
+class STICK_LOCAL ScratchAllocator : public stick::Allocator
+{
+  public:
+    struct Marker
+    {
+        Size chunk;
+        Size offset;
+    };
+
+    ScratchAllocator(Size _chunkSize = 64 * 1024);
+
+    ~ScratchAllocator();
+
+    stick::Block allocate(Size _byteCount, Size _alignment) override;
+
+    void deallocate(const stick::Block & _block) override;
+
+    Marker marker() const;
+
+    // releases everything allocated after _marker was taken.
+    void rewind(const Marker & _marker);
+
+  private:
+    Size m_chunkSize;
+    stick::DynamicArray<stick::Block> m_chunks;
+    Size m_chunk;
+    Size m_offset;
+};
+
+// the scratch allocator of the calling thread.
+STICK_LOCAL ScratchAllocator & scratchAllocator();
+
+// releases all scratch memory that was allocated during its lifetime when it goes out of scope.
+// Declare it before the arrays that use allocator() so they are destroyed first. Arrays that
+// were created outside of the scope must not grow inside of it.
+class STICK_LOCAL ScratchScope
+{
+  public:
+    ScratchScope() : m_alloc(scratchAllocator()), m_marker(m_alloc.marker())
+    {
+    }
+
+    ScratchScope(const ScratchScope &) = delete;
+    ScratchScope & operator=(const ScratchScope &) = delete;
+
+    ~ScratchScope()
+    {
+        m_alloc.rewind(m_marker);
+    }
+
+    stick::Allocator & allocator()
+    {
+        return m_alloc;
+    }
+
+  private:
+    ScratchAllocator & m_alloc;
+    ScratchAllocator::Marker m_marker;
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_SCRATCHALLOCATOR_HPP
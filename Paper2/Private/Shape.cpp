@@ -2,74 +2,161 @@
 #include <Paper2/Path.hpp>
 #include <Paper2/Private/Shape.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace paper
 {
 namespace detail
 {
-Shape::Shape() : m_type(ShapeType::None)
+namespace
+{
+// closeness relative to the size of the shape, so big shapes don't fail on rounding errors
+bool isNear(Float _a, Float _b, Float _scale)
+{
+    return std::abs(_a - _b) <= PaperConstants::tolerance() * std::max((Float)1, _scale);
+}
+
+// the curve that approximates a quarter of the ellipse with _radius around the origin
+Bezier quarterArc(const Vec2f & _radius)
+{
+    static const Float s_kappa = PaperConstants::kappa();
+    return Bezier(Vec2f(_radius.x, 0),
+                  Vec2f(_radius.x, _radius.y * s_kappa),
+                  Vec2f(_radius.x * s_kappa, _radius.y),
+                  Vec2f(0, _radius.y));
+}
+
+// area between the unit quarter arc and its center, the area of elliptic arcs is scaled by both
+// radii.
+Float quarterArcArea()
+{
+    static const Float s_area = std::abs(quarterArc(Vec2f(1)).area());
+    return s_area;
+}
+} // namespace
+
+Shape::Shape() : m_type(ShapeType::None), m_bClockwise(false), m_bAxisAligned(false)
 {
 }
 
-Shape::Shape(const Path * _path) : m_type(ShapeType::None)
+Shape::Shape(const Path * _path) :
+    m_type(ShapeType::None),
+    m_bClockwise(false),
+    m_bAxisAligned(false)
 {
+    if (!_path->isClosed())
+        return;
+
     ConstCurveView curves = _path->curves();
     ConstSegmentView segments = _path->segments();
     if (curves.count() == 4 && curves[0].isArc() && curves[1].isArc() && curves[2].isArc() &&
         curves[3].isArc())
     {
-        if (crunch::isClose(crunch::length(segments[0].position() - segments[2].position()) -
-                                crunch::length(segments[1].position() - segments[3].position()),
+        Vec2f a = segments[0].position();
+        Vec2f b = segments[1].position();
+        Vec2f c = segments[2].position();
+        Vec2f d = segments[3].position();
+        Vec2f diagonals = crunch::abs(a - c) + crunch::abs(b - d);
+        Float scale = std::max(diagonals.x, diagonals.y);
+        bool bAligned = (isNear(a.y, c.y, scale) && isNear(b.x, d.x, scale)) ||
+                        (isNear(a.x, c.x, scale) && isNear(b.y, d.y, scale));
+
+        if (crunch::isClose(crunch::length(a - c) - crunch::length(b - d),
                             (Float)0,
                             PaperConstants::epsilon()))
         {
             m_type = ShapeType::Circle;
-            m_data.circle.position =
-                segments[2].position() + (segments[0].position() - segments[2].position()) * 0.5;
-            m_data.circle.radius =
-                crunch::distance(segments[0].position(), segments[2].position()) * 0.5;
+            m_data.circle.position = c + (a - c) * 0.5;
+            m_data.circle.radius = crunch::distance(a, c) * 0.5;
+            m_bAxisAligned = bAligned;
         }
-        else
+        else if (bAligned)
         {
+            // the size has no rotation, so rotated ellipses are not recognized
             m_type = ShapeType::Ellipse;
-            m_data.circle.position =
-                segments[2].position() + (segments[0].position() - segments[2].position()) * 0.5;
-            m_data.ellipse.size =
-                Vec2f(crunch::distance(segments[0].position(), segments[2].position()),
-                      crunch::distance(segments[1].position(), segments[3].position()));
+            m_data.ellipse.position = c + (a - c) * 0.5;
+            m_data.ellipse.size = diagonals;
+            m_bAxisAligned = true;
         }
     }
     else if (_path->isPolygon() && curves.count() == 4 && curves[0].isCollinear(curves[2]) &&
              curves[1].isCollinear(curves[3]) && curves[1].isOrthogonal(curves[0]))
     {
-        m_type = ShapeType::Rectangle;
-        // m_data.circle.position = _path.localBounds().center();
-        Float w = segments[0].position().x - segments[3].position().x;
-        Float h = segments[2].position().y - segments[3].position().y;
-
-        m_data.rectangle.position =
-            Vec2f(segments[3].position().x + w * 0.5, segments[3].position().y + h * 0.5);
+        Vec2f d = crunch::abs(segments[1].position() - segments[0].position());
+        Float scale = std::max(d.x, d.y);
+        if (isNear(d.x, 0, scale) || isNear(d.y, 0, scale))
+        {
+            Vec2f min = segments[0].position();
+            Vec2f max = min;
+            for (Size i = 1; i < 4; ++i)
+            {
+                min = crunch::min(min, segments[i].position());
+                max = crunch::max(max, segments[i].position());
+            }
 
-        m_data.rectangle.size = Vec2f(w, h);
-        m_data.rectangle.cornerRadius = Vec2f(0);
+            m_type = ShapeType::Rectangle;
+            m_data.rectangle.position = (min + max) * 0.5;
+            m_data.rectangle.size = max - min;
+            m_data.rectangle.cornerRadius = Vec2f(0);
+            m_bAxisAligned = true;
+        }
     }
-    //@TODO: Double check this once we reintroduced rounded rectangle again
     else if (curves.count() == 8 && curves[1].isArc() && curves[3].isArc() && curves[5].isArc() &&
              curves[7].isArc() && curves[0].isCollinear(curves[4]) &&
-             curves[2].isCollinear(curves[6]))
+             curves[2].isCollinear(curves[6]) && curves[0].isOrthogonal(curves[2]))
     {
-
         // rounded rect
-        m_type = ShapeType::Rectangle;
-
-        m_data.rectangle.position = _path->bounds().center();
-        m_data.rectangle.size =
-            Vec2f(crunch::distance(segments[7].position(), segments[2].position()),
-                  crunch::distance(segments[0].position(), segments[5].position()));
-        m_data.rectangle.cornerRadius =
-            (m_data.rectangle.size -
-             Vec2f(crunch::distance(segments[0].position(), segments[1].position()),
-                   crunch::distance(segments[2].position(), segments[3].position()))) *
-            0.5;
+        Vec2f min = segments[0].position();
+        Vec2f max = min;
+        for (Size i = 1; i < 8; ++i)
+        {
+            min = crunch::min(min, segments[i].position());
+            max = crunch::max(max, segments[i].position());
+        }
+        Vec2f size = max - min;
+        Float scale = std::max(size.x, size.y);
+
+        Vec2f d0 = crunch::abs(segments[1].position() - segments[0].position());
+        Vec2f d2 = crunch::abs(segments[3].position() - segments[2].position());
+        bool bHorizontal = isNear(d0.y, 0, scale);
+        if (bHorizontal || isNear(d0.x, 0, scale))
+        {
+            Vec2f radius =
+                (size - (bHorizontal ? Vec2f(d0.x, d2.y) : Vec2f(d2.x, d0.y))) * 0.5;
+
+            // all corners need to span the same radius
+            bool bCorners = true;
+            for (Size i = 1; i < 8 && bCorners; i += 2)
+            {
+                Vec2f d =
+                    crunch::abs(segments[(i + 1) % 8].position() - segments[i].position());
+                bCorners = isNear(d.x, radius.x, scale) && isNear(d.y, radius.y, scale);
+            }
+
+            if (bCorners)
+            {
+                m_type = ShapeType::Rectangle;
+                m_data.rectangle.position = (min + max) * 0.5;
+                m_data.rectangle.size = size;
+                m_data.rectangle.cornerRadius = radius;
+                m_bAxisAligned = true;
+            }
+        }
+    }
+
+    if (m_type != ShapeType::None)
+    {
+        // the curves of all these shapes bulge out evenly, so the polygon of the segments has
+        // the same orientation.
+        Float sum = 0;
+        for (Size i = 0; i < segments.count(); ++i)
+        {
+            const Vec2f & a = segments[i].position();
+            const Vec2f & b = segments[(i + 1) % segments.count()].position();
+            sum += a.x * b.y - b.x * a.y;
+        }
+        m_bClockwise = sum >= 0;
     }
 }
 
@@ -92,5 +179,175 @@ const Shape::Rectangle & Shape::rectangle() const
 {
     return m_data.rectangle;
 }
+
+bool Shape::isClockwise() const
+{
+    return m_bClockwise;
+}
+
+bool Shape::isAxisAligned() const
+{
+    return m_bAxisAligned;
+}
+
+bool Shape::transformed(const Mat32f & _transform, Shape & _out) const
+{
+    // with a zero diagonal the axes swap
+    const Vec2f & u = _transform[0];
+    const Vec2f & v = _transform[1];
+    bool bSwap = u.x == 0 && v.y == 0;
+    if (!bSwap && (u.y != 0 || v.x != 0))
+        return false;
+
+    Vec2f scale = bSwap ? Vec2f(std::abs(v.x), std::abs(u.y)) : Vec2f(std::abs(u.x), std::abs(v.y));
+    if (scale.x == 0 || scale.y == 0)
+        return false;
+
+    auto transformSize = [&](const Vec2f & _size) {
+        return (bSwap ? Vec2f(_size.y, _size.x) : _size) * scale;
+    };
+
+    _out = *this;
+    // mirroring flips the orientation
+    if (u.x * v.y - v.x * u.y < 0)
+        _out.m_bClockwise = !m_bClockwise;
+
+    switch (m_type)
+    {
+    case ShapeType::Circle:
+        if (scale.x == scale.y)
+        {
+            _out.m_data.circle.position = _transform * m_data.circle.position;
+            _out.m_data.circle.radius = m_data.circle.radius * scale.x;
+        }
+        else
+        {
+            // the segments have to be on the axes for the curves to match the ellipse bounds
+            if (!m_bAxisAligned)
+                return false;
+            _out.m_type = ShapeType::Ellipse;
+            _out.m_data.ellipse.position = _transform * m_data.circle.position;
+            _out.m_data.ellipse.size = Vec2f(m_data.circle.radius * 2) * scale;
+        }
+        return true;
+    case ShapeType::Ellipse:
+        _out.m_data.ellipse.position = _transform * m_data.ellipse.position;
+        _out.m_data.ellipse.size = transformSize(m_data.ellipse.size);
+        return true;
+    case ShapeType::Rectangle:
+        _out.m_data.rectangle.position = _transform * m_data.rectangle.position;
+        _out.m_data.rectangle.size = transformSize(m_data.rectangle.size);
+        _out.m_data.rectangle.cornerRadius = transformSize(m_data.rectangle.cornerRadius);
+        return true;
+    default:
+        return false;
+    }
+}
+
+Rect Shape::bounds(Float _padding) const
+{
+    Vec2f center, half;
+    if (m_type == ShapeType::Circle)
+    {
+        center = m_data.circle.position;
+        half = Vec2f(m_data.circle.radius);
+    }
+    else if (m_type == ShapeType::Ellipse)
+    {
+        center = m_data.ellipse.position;
+        half = m_data.ellipse.size * 0.5;
+    }
+    else
+    {
+        center = m_data.rectangle.position;
+        half = m_data.rectangle.size * 0.5;
+    }
+    half += Vec2f(_padding);
+    return Rect(center - half, center + half);
+}
+
+Float Shape::area() const
+{
+    Float ret = 0;
+    if (m_type == ShapeType::Circle)
+        ret = quarterArcArea() * m_data.circle.radius * m_data.circle.radius * 4;
+    else if (m_type == ShapeType::Ellipse)
+        ret = quarterArcArea() * m_data.ellipse.size.x * m_data.ellipse.size.y;
+    else if (m_type == ShapeType::Rectangle)
+    {
+        // the corners cut off the difference between their bounds and the quarter arc
+        const Rectangle & r = m_data.rectangle;
+        ret = r.size.x * r.size.y -
+              r.cornerRadius.x * r.cornerRadius.y * (1 - quarterArcArea()) * 4;
+    }
+    return m_bClockwise ? ret : -ret;
+}
+
+bool Shape::contains(const Vec2f & _point) const
+{
+    if (m_type == ShapeType::Circle)
+    {
+        return crunch::distanceSquared(_point, m_data.circle.position) <=
+               m_data.circle.radius * m_data.circle.radius;
+    }
+    else if (m_type == ShapeType::Ellipse)
+    {
+        Vec2f d = _point - m_data.ellipse.position;
+        Float x = d.x * 2 / m_data.ellipse.size.x;
+        Float y = d.y * 2 / m_data.ellipse.size.y;
+        return x * x + y * y <= 1;
+    }
+    else if (m_type == ShapeType::Rectangle)
+    {
+        const Rectangle & r = m_data.rectangle;
+        Vec2f d = crunch::abs(_point - r.position);
+        Vec2f half = r.size * 0.5;
+        if (d.x > half.x || d.y > half.y)
+            return false;
+
+        // only the corners outside of the straight edges are rounded
+        Vec2f inner = half - r.cornerRadius;
+        if (d.x <= inner.x || d.y <= inner.y)
+            return true;
+        Float x = (d.x - inner.x) / r.cornerRadius.x;
+        Float y = (d.y - inner.y) / r.cornerRadius.y;
+        return x * x + y * y <= 1;
+    }
+    return false;
+}
+
+bool Shape::closestPoint(const Vec2f & _point, Vec2f & _outPosition) const
+{
+    if (m_type == ShapeType::Circle)
+    {
+        const Circle & c = m_data.circle;
+        Vec2f d = _point - c.position;
+        Float len = crunch::length(d);
+        _outPosition = c.position + (len > 0 ? d * (c.radius / len) : Vec2f(c.radius, 0));
+        return true;
+    }
+    else if (m_type == ShapeType::Rectangle && m_data.rectangle.cornerRadius == Vec2f(0))
+    {
+        const Rectangle & r = m_data.rectangle;
+        Vec2f half = r.size * 0.5;
+        Vec2f d = _point - r.position;
+        if (std::abs(d.x) > half.x || std::abs(d.y) > half.y)
+        {
+            _outPosition = r.position + crunch::max(crunch::min(d, half), Vec2f(0) - half);
+        }
+        else
+        {
+            // inside, move to the closest edge
+            Float sx = d.x < 0 ? -1 : 1;
+            Float sy = d.y < 0 ? -1 : 1;
+            if (half.x - std::abs(d.x) < half.y - std::abs(d.y))
+                _outPosition = r.position + Vec2f(sx * half.x, d.y);
+            else
+                _outPosition = r.position + Vec2f(d.x, sy * half.y);
+        }
+        return true;
+    }
+    return false;
+}
 } // namespace detail
 } // namespace paper
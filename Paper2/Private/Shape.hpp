@@ -48,8 +48,35 @@ class STICK_LOCAL Shape
 
     const Rectangle & rectangle() const;
 
+    // same as Path::isClockwise
+    bool isClockwise() const;
+
+    // true if the curves have their extrema at the segments, so the bounds of the shape are the
+    // bounds of the curves. Only circles can be recognized without being axis aligned.
+    bool isAxisAligned() const;
+
+    // the shape after applying _transform. Returns false if the transform rotates or skews it,
+    // flips and multiples of 90 degrees are fine.
+    bool transformed(const Mat32f & _transform, Shape & _out) const;
+
+    // closed form versions of the path queries. bounds and area match the curves the shape was
+    // recognized from. contains and closestPoint use the ideal circle or ellipse, which the
+    // curves deviate from by less than 0.03% of the radius. There is no length, it has to agree
+    // with the offsets of the curves along the path which are integrated numerically.
+    Rect bounds(Float _padding) const;
+
+    // signed like Path::area
+    Float area() const;
+
+    bool contains(const Vec2f & _point) const;
+
+    // returns false if there is no closed form, i.e. for ellipses and rounded corners
+    bool closestPoint(const Vec2f & _point, Vec2f & _outPosition) const;
+
   private:
     ShapeType m_type;
+    bool m_bClockwise;
+    bool m_bAxisAligned;
 
     union Data
     {
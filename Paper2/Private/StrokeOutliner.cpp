@@ -0,0 +1,314 @@
+#include <Paper2/Private/StrokeOutliner.hpp>
+
+#include <Crunch/CommonFunc.hpp>
+
+#include <cmath>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+// max distance between a round join or cap and the polygon approximating it
+static const Float s_arcTolerance = 0.1f;
+
+static inline Vec2f perpendicular(const Vec2f & _dir)
+{
+    return Vec2f(-_dir.y, _dir.x);
+}
+
+static inline Vec2f direction(const Vec2f & _from, const Vec2f & _to)
+{
+    return crunch::normalize(_to - _from);
+}
+
+static inline void appendUnique(Polygon & _poly, const Vec2f & _p)
+{
+    if (!_poly.count() ||
+        crunch::distance(_poly.last(), _p) > PaperConstants::geometricEpsilon())
+        _poly.append(_p);
+}
+
+StrokeOutliner::StrokeOutliner(Float _strokeWidth,
+                               StrokeJoin _join,
+                               StrokeCap _cap,
+                               Float _miterLimit,
+                               const DashArray & _dashArray,
+                               Float _dashOffset,
+                               PolygonArray & _outPolygons) :
+    m_halfWidth(_strokeWidth * 0.5f),
+    m_join(_join),
+    m_cap(_cap),
+    m_miterLimit(_miterLimit),
+    m_dashes(_dashArray, _dashOffset),
+    m_polygons(&_outPolygons),
+    m_clean(_outPolygons.allocator()),
+    m_tmp(_outPolygons.allocator())
+{
+}
+
+void StrokeOutliner::addPolyline(const Vec2f * _positions, Size _count, bool _bClosed)
+{
+    if (m_halfWidth <= 0)
+        return;
+
+    m_clean.clear();
+    for (Size i = 0; i < _count; ++i)
+        appendUnique(m_clean, _positions[i]);
+
+    if (_bClosed && m_clean.count() > 1 &&
+        crunch::distance(m_clean.last(), m_clean[0]) <= PaperConstants::geometricEpsilon())
+        m_clean.removeLast();
+
+    if (!m_clean.count())
+        return;
+
+    if (m_dashes.isValid() && m_clean.count() > 1)
+        addDashes(&m_clean[0], m_clean.count(), _bClosed);
+    else if (_bClosed && m_clean.count() > 1)
+        addClosed(&m_clean[0], m_clean.count());
+    else
+        addOpen(&m_clean[0], m_clean.count(), Vec2f(1, 0));
+}
+
+Int32 StrokeOutliner::winding(const Vec2f & _point, const PolygonArray & _polygons)
+{
+    // crossing test against a horizontal ray to the right of _point
+    Int32 ret = 0;
+    for (const Polygon & poly : _polygons)
+    {
+        if (!poly.count())
+            continue;
+
+        Vec2f a = poly.last();
+        for (const Vec2f & b : poly)
+        {
+            if (a.y <= _point.y)
+            {
+                if (b.y > _point.y &&
+                    (b.x - a.x) * (_point.y - a.y) - (_point.x - a.x) * (b.y - a.y) > 0)
+                    ++ret;
+            }
+            else if (b.y <= _point.y &&
+                     (b.x - a.x) * (_point.y - a.y) - (_point.x - a.x) * (b.y - a.y) < 0)
+                --ret;
+            a = b;
+        }
+    }
+    return ret;
+}
+
+void StrokeOutliner::addDashes(const Vec2f * _positions, Size _count, bool _bClosed)
+{
+    m_dashes.start();
+    bool bOn = m_dashes.isOn();
+
+    m_tmp.clear();
+    if (bOn)
+        m_tmp.append(_positions[0]);
+
+    Vec2f dir(1, 0);
+    Size segmentCount = _bClosed ? _count : _count - 1;
+    for (Size i = 0; i < segmentCount; ++i)
+    {
+        const Vec2f & a = _positions[i];
+        const Vec2f & b = _positions[(i + 1) % _count];
+        Float len = crunch::distance(a, b);
+        dir = (b - a) / len;
+
+        Float pos = 0;
+        while (len - pos > m_dashes.remaining())
+        {
+            pos += m_dashes.remaining();
+            Vec2f p = a + dir * pos;
+            if (bOn)
+            {
+                appendUnique(m_tmp, p);
+                addOpen(&m_tmp[0], m_tmp.count(), dir);
+                m_tmp.clear();
+            }
+            else
+            {
+                m_tmp.clear();
+                m_tmp.append(p);
+            }
+
+            m_dashes.next();
+            bOn = m_dashes.isOn();
+        }
+
+        m_dashes.advance(len - pos);
+        if (bOn)
+            appendUnique(m_tmp, b);
+    }
+
+    if (bOn && m_tmp.count())
+        addOpen(&m_tmp[0], m_tmp.count(), dir);
+}
+
+void StrokeOutliner::addOpen(const Vec2f * _positions, Size _count, const Vec2f & _direction)
+{
+    Polygon poly(m_polygons->allocator());
+    if (_count == 1)
+    {
+        // zero length path or dash, only the caps are visible.
+        if (m_cap == StrokeCap::Butt)
+            return;
+
+        poly.append(_positions[0] + perpendicular(_direction) * m_halfWidth);
+        appendCap(poly, _positions[0], _direction);
+        appendCap(poly, _positions[0], -_direction);
+    }
+    else
+    {
+        // down the left side, around the end, back along the right side and around the start
+        appendSide(poly, _positions, _count, false, false);
+        appendCap(
+            poly, _positions[_count - 1], direction(_positions[_count - 2], _positions[_count - 1]));
+        appendSide(poly, _positions, _count, true, false);
+        appendCap(poly, _positions[0], direction(_positions[1], _positions[0]));
+    }
+
+    // the last cap ends where the polygon started
+    poly.removeLast();
+    m_polygons->append(std::move(poly));
+}
+
+void StrokeOutliner::addClosed(const Vec2f * _positions, Size _count)
+{
+    // the two sides of a closed polyline are separate loops that wind in opposite directions.
+    // For two points both sides are the same loop around the line, so one is enough.
+    Polygon poly(m_polygons->allocator());
+    appendSide(poly, _positions, _count, false, true);
+    m_polygons->append(std::move(poly));
+
+    if (_count > 2)
+    {
+        Polygon other(m_polygons->allocator());
+        appendSide(other, _positions, _count, true, true);
+        m_polygons->append(std::move(other));
+    }
+}
+
+void StrokeOutliner::appendSide(
+    Polygon & _poly, const Vec2f * _positions, Size _count, bool _bReverse, bool _bClosed)
+{
+    // the left side of the reversed polyline is the right side of the original one.
+    auto at = [&](Size _i) -> const Vec2f & {
+        return _bReverse ? _positions[_count - 1 - _i] : _positions[_i];
+    };
+
+    if (_bClosed)
+    {
+        for (Size i = 0; i < _count; ++i)
+        {
+            const Vec2f & prev = at((i + _count - 1) % _count);
+            const Vec2f & next = at((i + 1) % _count);
+            appendJoin(_poly, at(i), direction(prev, at(i)), direction(at(i), next));
+        }
+    }
+    else
+    {
+        _poly.append(at(0) + perpendicular(direction(at(0), at(1))) * m_halfWidth);
+        for (Size i = 1; i < _count - 1; ++i)
+            appendJoin(_poly, at(i), direction(at(i - 1), at(i)), direction(at(i), at(i + 1)));
+        _poly.append(at(_count - 1) +
+                     perpendicular(direction(at(_count - 2), at(_count - 1))) * m_halfWidth);
+    }
+}
+
+void StrokeOutliner::appendJoin(Polygon & _poly,
+                                const Vec2f & _position,
+                                const Vec2f & _dirA,
+                                const Vec2f & _dirB)
+{
+    Vec2f na = perpendicular(_dirA) * m_halfWidth;
+    Vec2f nb = perpendicular(_dirB) * m_halfWidth;
+    Float cross = _dirA.x * _dirB.y - _dirA.y * _dirB.x;
+    Float dot = crunch::dot(_dirA, _dirB);
+
+    // (almost) straight, no join needed
+    if (dot >= 1 - PaperConstants::trigonometricEpsilon())
+    {
+        _poly.append(_position + na);
+        return;
+    }
+
+    // inner side of the corner. Going through the corner itself keeps the polygon from
+    // winding backwards where the two offset segments overlap.
+    if (cross > 0)
+    {
+        _poly.append(_position + na);
+        _poly.append(_position);
+        _poly.append(_position + nb);
+        return;
+    }
+
+    if (m_join == StrokeJoin::Miter)
+    {
+        // the ratio between miter length and stroke width is 1 / sin(theta / 2) where theta is
+        // the angle between the segments, which is sqrt(2 / (1 + dot)).
+        Float d = 1 + dot;
+        if (d > PaperConstants::trigonometricEpsilon() && 2 / d <= m_miterLimit * m_miterLimit)
+        {
+            _poly.append(_position + na);
+            _poly.append(_position + (na + nb) / d);
+            _poly.append(_position + nb);
+            return;
+        }
+    }
+    else if (m_join == StrokeJoin::Round)
+    {
+        // outer joins always turn clockwise, this also picks the right way around for a u-turn.
+        _poly.append(_position + na);
+        appendArc(_poly, _position, na, -std::acos(crunch::max(dot, (Float)-1)));
+        return;
+    }
+
+    // bevel, or a miter that exceeds the miter limit
+    _poly.append(_position + na);
+    _poly.append(_position + nb);
+}
+
+void StrokeOutliner::appendCap(Polygon & _poly, const Vec2f & _position, const Vec2f & _direction)
+{
+    // the polygon is at the left side of _position, the cap goes around the front to the right.
+    Vec2f n = perpendicular(_direction) * m_halfWidth;
+    if (m_cap == StrokeCap::Square)
+    {
+        Vec2f ext = _direction * m_halfWidth;
+        _poly.append(_position + n + ext);
+        _poly.append(_position - n + ext);
+        _poly.append(_position - n);
+    }
+    else if (m_cap == StrokeCap::Round)
+    {
+        appendArc(_poly, _position, n, -crunch::Constants<Float>::pi());
+    }
+    else
+    {
+        _poly.append(_position - n);
+    }
+}
+
+void StrokeOutliner::appendArc(Polygon & _poly,
+                               const Vec2f & _center,
+                               const Vec2f & _from,
+                               Float _angle)
+{
+    // pick the step so the chords stay within s_arcTolerance of the arc
+    Float step = m_halfWidth > s_arcTolerance
+                     ? 2 * std::acos(1 - s_arcTolerance / m_halfWidth)
+                     : crunch::Constants<Float>::halfPi();
+    Size steps = crunch::max((Size)1, (Size)std::ceil(std::abs(_angle) / step));
+    for (Size i = 1; i <= steps; ++i)
+    {
+        Float a = _angle * i / steps;
+        Float c = std::cos(a);
+        Float s = std::sin(a);
+        _poly.append(_center + Vec2f(_from.x * c - _from.y * s, _from.x * s + _from.y * c));
+    }
+}
+} // namespace detail
+} // namespace paper
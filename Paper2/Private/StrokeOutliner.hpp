@@ -0,0 +1,65 @@
+#ifndef PAPER_PRIVATE_STROKEOUTLINER_HPP
+#define PAPER_PRIVATE_STROKEOUTLINER_HPP
+
+#include <Paper2/BasicTypes.hpp>
+#include <Paper2/Constants.hpp>
+#include <Paper2/Private/DashPattern.hpp>
+
+namespace paper
+{
+namespace detail
+{
+// turns polylines into polygons that cover the area of their stroke. All polygons are oriented
+// the same way, filled with the non zero winding rule they give the stroke, even where they
+// overlap (i.e. neighbouring dashes, inner joins or self intersecting paths).
+class STICK_LOCAL StrokeOutliner
+{
+  public:
+    StrokeOutliner(Float _strokeWidth,
+                   StrokeJoin _join,
+                   StrokeCap _cap,
+                   Float _miterLimit,
+                   const DashArray & _dashArray,
+                   Float _dashOffset,
+                   PolygonArray & _outPolygons);
+
+    // appends the outline of the stroke of the polyline, dashed if there is a dash array.
+    void addPolyline(const Vec2f * _positions, Size _count, bool _bClosed);
+
+    // winding number of _point with respect to the polygons, non zero means inside the stroke.
+    static Int32 winding(const Vec2f & _point, const PolygonArray & _polygons);
+
+  private:
+    void addDashes(const Vec2f * _positions, Size _count, bool _bClosed);
+
+    void addOpen(const Vec2f * _positions, Size _count, const Vec2f & _direction);
+
+    void addClosed(const Vec2f * _positions, Size _count);
+
+    // appends the left side of the polyline, traversed backwards if _bReverse is true.
+    void appendSide(
+        Polygon & _poly, const Vec2f * _positions, Size _count, bool _bReverse, bool _bClosed);
+
+    void appendJoin(Polygon & _poly,
+                    const Vec2f & _position,
+                    const Vec2f & _dirA,
+                    const Vec2f & _dirB);
+
+    void appendCap(Polygon & _poly, const Vec2f & _position, const Vec2f & _direction);
+
+    void appendArc(Polygon & _poly, const Vec2f & _center, const Vec2f & _from, Float _angle);
+
+    Float m_halfWidth;
+    StrokeJoin m_join;
+    StrokeCap m_cap;
+    Float m_miterLimit;
+    DashPattern m_dashes;
+    PolygonArray * m_polygons;
+    // the deduplicated input and the current dash
+    Polygon m_clean;
+    Polygon m_tmp;
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_STROKEOUTLINER_HPP
@@ -0,0 +1,89 @@
+#include <Paper2/Constants.hpp>
+#include <Paper2/Private/SweepLine.hpp>
+
+#include <algorithm>
+
+namespace paper
+{
+namespace detail
+{
+using namespace stick;
+
+static void appendMonotonePieces(const Bezier & _curve, Size _index, CurveBoundsArray & _outPieces)
+{
+    Float tMin = PaperConstants::curveTimeEpsilon();
+    Float tMax = 1 - tMin;
+
+    auto ex = _curve.extrema2D();
+    std::sort(&ex.values[0], &ex.values[0] + ex.count);
+
+    Float t0 = 0;
+    Vec2f p0 = _curve.positionOne();
+    for (Int32 i = 0; i < ex.count; ++i)
+    {
+        Float t1 = ex.values[i];
+        if (t1 <= t0 + tMin || t1 >= tMax)
+            continue;
+
+        Vec2f p1 = _curve.positionAt(t1);
+        _outPieces.append({ Rect(crunch::min(p0, p1), crunch::max(p0, p1)), _index });
+        t0 = t1;
+        p0 = p1;
+    }
+
+    const Vec2f & p1 = _curve.positionTwo();
+    _outPieces.append({ Rect(crunch::min(p0, p1), crunch::max(p0, p1)), _index });
+}
+
+void SweepLine::overlappingPairs(const DynamicArray<Bezier> & _curves,
+                                 CurvePairArray & _outPairs,
+                                 Float _epsilon)
+{
+    // a cubic has at most two extrema per axis, so most curves end up as one to three pieces.
+    CurveBoundsArray pieces(_outPairs.allocator());
+    pieces.reserve(_curves.count() * 3);
+    for (Size i = 0; i < _curves.count(); ++i)
+        appendMonotonePieces(_curves[i], i, pieces);
+
+    std::sort(pieces.begin(), pieces.end(), [](const CurveBounds & _a, const CurveBounds & _b) {
+        return _a.bounds.min().y < _b.bounds.min().y;
+    });
+
+    // the active list holds all pieces that the sweep line currently crosses. For an outline
+    // that is a handful of pieces no matter how many curves the path has.
+    DynamicArray<Size> active(_outPairs.allocator());
+    for (Size i = 0; i < pieces.count(); ++i)
+    {
+        const CurveBounds & piece = pieces[i];
+        for (Size k = 0; k < active.count();)
+        {
+            const CurveBounds & other = pieces[active[k]];
+            if (other.bounds.max().y < piece.bounds.min().y - _epsilon)
+            {
+                // the sweep line moved past this piece
+                active[k] = active.last();
+                active.removeLast();
+                continue;
+            }
+
+            if (other.index != piece.index &&
+                other.bounds.min().x <= piece.bounds.max().x + _epsilon &&
+                piece.bounds.min().x <= other.bounds.max().x + _epsilon)
+            {
+                _outPairs.append(other.index < piece.index ? CurvePair{ other.index, piece.index }
+                                                           : CurvePair{ piece.index, other.index });
+            }
+            ++k;
+        }
+        active.append(i);
+    }
+
+    // several pieces of the same two curves can overlap, only report each pair of curves once.
+    Broadphase::sortPairs(_outPairs);
+    auto it = std::unique(_outPairs.begin(), _outPairs.end(), [](const CurvePair & _a, const CurvePair & _b) {
+        return _a.a == _b.a && _a.b == _b.b;
+    });
+    _outPairs.resize(it - _outPairs.begin());
+}
+} // namespace detail
+} // namespace paper
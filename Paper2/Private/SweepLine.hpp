@@ -0,0 +1,26 @@
+#ifndef PAPER_PRIVATE_SWEEPLINE_HPP
+#define PAPER_PRIVATE_SWEEPLINE_HPP
+
+#include <Paper2/Private/Broadphase.hpp>
+
+namespace paper
+{
+namespace detail
+{
+// sweep line along the y axis over the pieces of the curves that are monotone in x and y.
+// The bounds of a monotone piece are spanned by its end points, which makes them a lot tighter
+// than the bounds of the whole curve. This is used for self intersections where the bounds of
+// the curves of a long contour tend to overlap a lot.
+struct STICK_LOCAL SweepLine
+{
+    // finds all pairs of curves in _curves that might intersect. CurvePair::a is always
+    // smaller than CurvePair::b, each pair is only reported once and the pairs are sorted by a,
+    // then b.
+    static void overlappingPairs(const stick::DynamicArray<Bezier> & _curves,
+                                 CurvePairArray & _outPairs,
+                                 Float _epsilon);
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_SWEEPLINE_HPP
@@ -0,0 +1,65 @@
+#ifndef PAPER_PRIVATE_TRANSFORMEDSEGMENTVIEW_HPP
+#define PAPER_PRIVATE_TRANSFORMEDSEGMENTVIEW_HPP
+
+#include <Paper2/Path.hpp>
+
+namespace paper
+{
+namespace detail
+{
+// read only view on the segments of a path with an optional transform. The segments are
+// transformed lazily, one curve at a time, so geometry queries in another space don't need to
+// copy the whole segment array first.
+class STICK_LOCAL TransformedSegmentView
+{
+  public:
+    TransformedSegmentView(const Path * _path, const Mat32f * _transform) :
+        m_segments(&_path->segmentData()),
+        m_transform(_transform),
+        m_curveCount(0)
+    {
+        if (m_segments->count() > 1)
+            m_curveCount = _path->isClosed() ? m_segments->count() : m_segments->count() - 1;
+    }
+
+    bool isTransformed() const
+    {
+        return m_transform != nullptr;
+    }
+
+    Size count() const
+    {
+        return m_segments->count();
+    }
+
+    Size curveCount() const
+    {
+        return m_curveCount;
+    }
+
+    Vec2f position(Size _index) const
+    {
+        const Vec2f & p = (*m_segments)[_index].position;
+        return m_transform ? *m_transform * p : p;
+    }
+
+    Bezier curveBezier(Size _index) const
+    {
+        const SegmentData & a = (*m_segments)[_index];
+        const SegmentData & b = (*m_segments)[(_index + 1) % m_segments->count()];
+        if (!m_transform)
+            return Bezier(a.position, a.handleOut, b.handleIn, b.position);
+
+        const Mat32f & t = *m_transform;
+        return Bezier(t * a.position, t * a.handleOut, t * b.handleIn, t * b.position);
+    }
+
+  private:
+    const SegmentDataArray * m_segments;
+    const Mat32f * m_transform;
+    Size m_curveCount;
+};
+} // namespace detail
+} // namespace paper
+
+#endif // PAPER_PRIVATE_TRANSFORMEDSEGMENTVIEW_HPP
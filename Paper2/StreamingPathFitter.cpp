@@ -0,0 +1,86 @@
+#include <Paper2/Private/PathFitter.hpp>
+#include <Paper2/StreamingPathFitter.hpp>
+
+namespace paper
+{
+using namespace stick;
+
+// with more pending points, all curves are finished. This keeps the cost per point bounded for
+// input that fits a single curve for a long time, i.e. straight lines.
+static const Size s_maxPendingPoints = 256;
+
+StreamingPathFitter::StreamingPathFitter(Path * _path, Float _tolerance) :
+    m_path(_path),
+    m_tolerance(_tolerance),
+    m_finishedCount(0),
+    m_pending(_path->segmentData().allocator()),
+    m_tangent(0),
+    m_handleIn(0),
+    m_tmpSegments(_path->segmentData().allocator()),
+    m_tmpCurveEnds(_path->segmentData().allocator())
+{
+    m_path->removeSegments();
+}
+
+void StreamingPathFitter::addPoint(const Vec2f & _point)
+{
+    if (m_pending.count() && m_pending.last() == _point)
+        return;
+    m_pending.append(_point);
+
+    detail::PathFitter fitter(
+        &m_pending[0], m_pending.count(), m_tolerance, m_tmpSegments.allocator());
+    fitter.fit(m_tangent, m_tmpSegments, m_tmpCurveEnds);
+
+    // the fit starts at the last finished segment, which keeps its handle in. Everything after
+    // it is replaced.
+    if (m_finishedCount)
+    {
+        m_tmpSegments[0].handleIn = m_handleIn;
+        m_path->removeSegments(m_finishedCount - 1);
+    }
+    else if (m_path->segmentData().count())
+        m_path->removeSegments();
+    m_path->addSegments(&m_tmpSegments[0], m_tmpSegments.count());
+
+    // a curve is stable once the fit needs another one after it
+    Size curveCount = m_tmpCurveEnds.count();
+    if (m_pending.count() > s_maxPendingPoints)
+        finishCurves(curveCount);
+    else if (curveCount > 1)
+        finishCurves(curveCount - 1);
+}
+
+void StreamingPathFitter::finish()
+{
+    if (m_pending.count() > 1)
+        finishCurves(m_tmpCurveEnds.count());
+}
+
+void StreamingPathFitter::finishCurves(Size _count)
+{
+    if (!_count)
+        return;
+
+    const SegmentData & last = m_tmpSegments[_count];
+    m_handleIn = last.handleIn;
+    m_tangent = last.position - last.handleIn;
+    m_finishedCount = m_finishedCount ? m_finishedCount + _count : _count + 1;
+    m_pending.remove(m_pending.begin(), m_pending.begin() + m_tmpCurveEnds[_count - 1]);
+}
+
+Size StreamingPathFitter::finishedSegmentCount() const
+{
+    return m_finishedCount;
+}
+
+Size StreamingPathFitter::pendingPointCount() const
+{
+    return m_pending.count();
+}
+
+Path * StreamingPathFitter::path() const
+{
+    return m_path;
+}
+} // namespace paper
@@ -0,0 +1,51 @@
+#ifndef PAPER_STREAMINGPATHFITTER_HPP
+#define PAPER_STREAMINGPATHFITTER_HPP
+
+#include <Paper2/Path.hpp>
+
+namespace paper
+{
+// simplifies a path while its points come in, i.e. from a pen tool. Only the points after the
+// last finished curve are fit again when a point is added, so the cost per point does not grow
+// with the length of the path. Curves are finished once the fit needs another curve after them.
+// The path always holds the finished segments followed by the current fit of the remaining
+// points.
+class STICK_API StreamingPathFitter
+{
+  public:
+    // the segments of _path are replaced by the fitted segments. _tolerance is the same as for
+    // Path::simplify.
+    StreamingPathFitter(Path * _path, Float _tolerance = 2.5);
+
+    void addPoint(const Vec2f & _point);
+
+    // finishes all remaining segments, call this once the input ends.
+    void finish();
+
+    // number of segments at the start of the path that won't change anymore. The handle out of
+    // the last one can still change until finish() is called.
+    Size finishedSegmentCount() const;
+
+    // number of points that are fit again on the next call to addPoint
+    Size pendingPointCount() const;
+
+    Path * path() const;
+
+  private:
+    // marks the first _count curves of the last fit as finished
+    void finishCurves(Size _count);
+
+    Path * m_path;
+    Float m_tolerance;
+    Size m_finishedCount;
+    // the points after the last finished segment, starting with its position
+    stick::DynamicArray<Vec2f> m_pending;
+    // the direction the remaining curves leave the last finished segment in, zero if none
+    Vec2f m_tangent;
+    Vec2f m_handleIn;
+    SegmentDataArray m_tmpSegments;
+    stick::DynamicArray<Size> m_tmpCurveEnds;
+};
+} // namespace paper
+
+#endif // PAPER_STREAMINGPATHFITTER_HPP
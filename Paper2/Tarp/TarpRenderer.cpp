@@ -9,6 +9,8 @@
 #define TARP_IMPLEMENTATION_OPENGL
 #include <Tarp/Tarp.h>
 
+#include <cstring>
+
 namespace paper
 {
 namespace tarp
@@ -223,30 +225,24 @@ static detail::TarpSymbolData & ensureRenderData(Symbol * _symbol)
 
 static void toTarpSegments(tpSegmentArray & _tmpData, Path * _path, const Mat32f * _transform)
 {
-    _tmpData.clear();
+    static_assert(sizeof(tpSegment) == sizeof(SegmentData),
+                  "tpSegment and SegmentData need to have the same layout");
+
+    const SegmentDataArray & segs = _path->segmentData();
+    _tmpData.resize(segs.count());
+    if (!segs.count())
+        return;
+
+    SegmentData * out = reinterpret_cast<SegmentData *>(&_tmpData[0]);
     if (!_transform)
     {
-        for (Size i = 0; i < _path->segmentData().count(); ++i)
-        {
-            ConstSegment seg = _path->segment(i);
-            Vec2f hi = seg.handleInAbsolute();
-            Vec2f ho = seg.handleOutAbsolute();
-            _tmpData.append((tpSegment){
-                { hi.x, hi.y }, { seg.position().x, seg.position().y }, { ho.x, ho.y } });
-        }
+        std::memcpy(out, &segs[0], sizeof(SegmentData) * segs.count());
     }
     else
     {
         // tarp does not support per contour transforms, so we need to bring child paths segments
         // to path space before adding it as a contour!
-        for (Size i = 0; i < _path->segmentData().count(); ++i)
-        {
-            ConstSegment seg = _path->segment(i);
-            Vec2f hi = *_transform * seg.handleInAbsolute();
-            Vec2f pos = *_transform * seg.position();
-            Vec2f ho = *_transform * seg.handleOutAbsolute();
-            _tmpData.append((tpSegment){ { hi.x, hi.y }, { pos.x, pos.y }, { ho.x, ho.y } });
-        }
+        segments::transform(*_transform, &segs[0], out, segs.count());
     }
 }
 
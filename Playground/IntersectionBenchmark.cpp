@@ -0,0 +1,99 @@
+// This compares the self intersection code of paper against testing every curve
+// of a path against every other curve.
+
+#include <Paper2/Document.hpp>
+#include <Paper2/Path.hpp>
+
+#include <Crunch/Randomizer.hpp>
+#include <Stick/SystemClock.hpp>
+
+#include <cmath>
+
+using namespace paper;
+using namespace crunch;
+using namespace stick;
+
+static Size bruteForceSelfIntersections(const Path * _path)
+{
+    Size count = 0;
+    Size curveCount = _path->curveCount();
+    for (Size i = 0; i < curveCount; ++i)
+    {
+        Bezier a = _path->curve(i).bezier();
+        for (Size j = i + 1; j < curveCount; ++j)
+        {
+            // skip the shared end point of adjacent curves
+            if (j == i + 1 || (_path->isClosed() && i == 0 && j == curveCount - 1))
+                continue;
+            count += a.intersections(_path->curve(j).bezier()).count;
+        }
+    }
+    return count;
+}
+
+static void benchmark(const char * _name, const Path * _path, Size _iterations)
+{
+    SystemClock clk;
+
+    Size sweepCount = 0;
+    auto start = clk.now();
+    for (Size i = 0; i < _iterations; ++i)
+        sweepCount = _path->intersectionsLocal().count();
+    Float sweepTime = (clk.now() - start).seconds() / _iterations;
+
+    Size bruteCount = 0;
+    start = clk.now();
+    for (Size i = 0; i < _iterations; ++i)
+        bruteCount = bruteForceSelfIntersections(_path);
+    Float bruteTime = (clk.now() - start).seconds() / _iterations;
+
+    printf("%s (%lu curves)\n", _name, _path->curveCount());
+    printf("    sweep line:  %f ms, %lu intersections\n", sweepTime * 1000.0, sweepCount);
+    printf("    brute force: %f ms, %lu intersections\n", bruteTime * 1000.0, bruteCount);
+}
+
+int main(int _argc, const char * _args[])
+{
+    Document doc;
+    Randomizer rnd;
+
+    for (Size count : { 100, 1000, 10000 })
+    {
+        printf("\n%lu segments\n", count);
+
+        // brute force gets slow fast
+        Size iterations = count < 10000 ? 10 : 1;
+
+        // spiral, curves only touch their neighbours
+        Path * spiral = doc.createPath();
+        for (Size i = 0; i < count; ++i)
+        {
+            Float a = i * 0.1f;
+            spiral->addPoint(Vec2f(cos(a), sin(a)) * (10.0f + a * 4.0f));
+        }
+        spiral->smooth();
+        benchmark("smooth spiral", spiral, iterations);
+
+        // contour along a circle with some noise, like a traced outline
+        Path * outline = doc.createPath();
+        for (Size i = 0; i < count; ++i)
+        {
+            Float a = (Float)i / count * Constants<Float>::twoPi();
+            outline->addPoint(Vec2f(cos(a), sin(a)) * (1000.0f + rnd.randomf(-2, 2)));
+        }
+        outline->closePath();
+        benchmark("noisy outline", outline, iterations);
+
+        // random walk, lots of actual intersections
+        Path * walk = doc.createPath();
+        Vec2f pos(0, 0);
+        for (Size i = 0; i < count; ++i)
+        {
+            walk->addPoint(pos);
+            pos += Vec2f(rnd.randomf(-10, 10), rnd.randomf(-10, 10));
+        }
+        benchmark("random walk", walk, iterations);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+// This compares transforming segments one Vec2f at a time against the batch
+// transform kernel that paper uses internally.
+
+#include <Paper2/Path.hpp>
+
+#include <Crunch/Randomizer.hpp>
+#include <Stick/SystemClock.hpp>
+
+using namespace paper;
+using namespace crunch;
+using namespace stick;
+
+static void transformPerPoint(const Mat32f & _transform, SegmentDataArray & _segs)
+{
+    for (auto & seg : _segs)
+    {
+        seg.handleIn = _transform * seg.handleIn;
+        seg.position = _transform * seg.position;
+        seg.handleOut = _transform * seg.handleOut;
+    }
+}
+
+int main(int _argc, const char * _args[])
+{
+    Randomizer rnd;
+
+    // rotate by a tiny amount so repeated application does not blow up the values
+    Mat32f transform = Mat32f::rotation(0.001f);
+    transform.translate(Vec2f(0.01f, -0.01f));
+
+    for (Size count : { 1000, 100000, 1000000 })
+    {
+        Size iterations = count < 100000 ? 1000 : 20;
+
+        SegmentDataArray segs(count);
+        for (auto & seg : segs)
+        {
+            seg.position = Vec2f(rnd.randomf(-1000, 1000), rnd.randomf(-1000, 1000));
+            seg.handleIn = seg.position + Vec2f(rnd.randomf(-10, 10), rnd.randomf(-10, 10));
+            seg.handleOut = seg.position + Vec2f(rnd.randomf(-10, 10), rnd.randomf(-10, 10));
+        }
+        SegmentDataArray a = segs;
+        SegmentDataArray b = segs;
+
+        SystemClock clk;
+        auto start = clk.now();
+        for (Size i = 0; i < iterations; ++i)
+            transformPerPoint(transform, a);
+        Float perPointTime = (clk.now() - start).seconds() / iterations;
+
+        start = clk.now();
+        for (Size i = 0; i < iterations; ++i)
+            segments::transform(transform, &b[0], &b[0], b.count());
+        Float batchTime = (clk.now() - start).seconds() / iterations;
+
+        // make sure both produce the same result
+        Float maxDiff = 0;
+        for (Size i = 0; i < count; ++i)
+            maxDiff = crunch::max(maxDiff, crunch::distance(a[i].position, b[i].position));
+
+        printf("\n%lu segments\n", count);
+        printf("    per point: %f ms\n", perPointTime * 1000.0);
+        printf("    batch:     %f ms\n", batchTime * 1000.0);
+        printf("    max difference: %f\n", maxDiff);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -2,8 +2,11 @@
 #include <Paper2/Document.hpp>
 #include <Paper2/Group.hpp>
 #include <Paper2/Path.hpp>
+#include <Paper2/StreamingPathFitter.hpp>
 #include <Crunch/StringConversion.hpp>
 #include <Stick/Test.hpp>
+
+#include <cmath>
 // #include <Paper/Private/ContainerView.hpp>
 
 using namespace stick;
@@ -160,6 +163,21 @@ const Suite spec[] =
             EXPECT(c.handleTwo() == expectedCurves2[i++]);
             EXPECT(c.positionTwo() == expectedCurves2[i++]);
         }
+
+        // test removal, the cached curve data has to match a freshly built path
+        Float len = p->length();
+        p->removeSegment(1);
+        EXPECT(p->curves().count() == 3);
+        EXPECT(p->curves()[0].positionTwo() == Vec2f(200.0f, 30.0f));
+        Path * p2 = doc.createPath();
+        p2->addSegments(&p->segmentData()[0], p->segmentData().count());
+        p2->closePath();
+        EXPECT(isClose(p->length(), p2->length()));
+        EXPECT(!isClose(p->length(), len));
+
+        p->removeSegments(2);
+        EXPECT(p->curves().count() == 2);
+        EXPECT(p->curves().last().positionTwo() == Vec2f(100.0f, 30.0f));
     },
     SUITE("Attribute Tests")
     {
@@ -199,6 +217,63 @@ const Suite spec[] =
         Float circumference = Constants<Float>::pi() * rad * 2;
         printf("%f %f\n", p2->length(), circumference);
         EXPECT(isClose(p2->length(), circumference, 0.1f));
+
+        // offset lookups
+        auto loc = p->curveLocationAt(300.0f);
+        EXPECT(loc.curve().index() == 1);
+        EXPECT(isClose(loc.offset(), 300.0f));
+        EXPECT(isClose(p->positionAt(100.0f), Vec2f(100.0f, 0.0f), 0.01f));
+        EXPECT(isClose(p->positionAt(200.0f), Vec2f(200.0f, 0.0f), 0.01f));
+        EXPECT(!p->curveLocationAt(500.0f).isValid());
+
+        // changing the path has to update the offsets
+        p->addPoint(Vec2f(0.0f, 200.0f));
+        EXPECT(isClose(p->length(), 600.0f));
+        EXPECT(isClose(p->positionAt(500.0f), Vec2f(100.0f, 200.0f), 0.01f));
+        EXPECT(p->curveLocationAt(500.0f).curve().index() == 2);
+
+        Path * p3 = doc.createPath();
+        p3->addPoint(Vec2f(0.0f, 0.0f));
+        p3->addPoint(Vec2f(100.0f, 0.0f));
+        p3->addPoint(Vec2f(100.0f, 100.0f));
+        p3->flattenRegular(10.0f);
+        // the length is a multiple of the distance, the end point has to stay anyway
+        EXPECT(p3->segmentCount() == 21);
+        EXPECT(p3->segment(20).position() == Vec2f(100.0f, 100.0f));
+        EXPECT(isClose(p3->segment(5).position(), Vec2f(50.0f, 0.0f), 0.01f));
+        EXPECT(isClose(p3->segment(10).position(), Vec2f(100.0f, 0.0f), 0.01f));
+        EXPECT(isClose(p3->segment(15).position(), Vec2f(100.0f, 50.0f), 0.01f));
+
+        // batch sampling, sorted and unsorted offsets
+        Float sampleOffsets[] = { 0.0f, 10.0f, 100.0f, 300.0f, 450.0f, 50.0f, 600.0f, 20.0f };
+        Vec2f positions[8];
+        Vec2f tangents[8];
+        p2->sampleAt(sampleOffsets, 8, positions, tangents);
+        for (Size i = 0; i < 8; ++i)
+        {
+            EXPECT(isClose(positions[i], p2->positionAt(sampleOffsets[i]), 0.01f));
+            EXPECT(isClose(tangents[i], p2->tangentAt(sampleOffsets[i]), 0.01f));
+        }
+
+        // the flattened positions are cached until the segments change
+        const auto & flat = p2->flattenedPositions();
+        Size flatCount = flat.count();
+        EXPECT(flatCount > p2->segmentCount());
+        EXPECT(&p2->flattenedPositions() == &flat && flat.count() == flatCount);
+        p2->segment(0).setPosition(Vec2f(200.0f, 0.0f));
+        EXPECT(isClose(p2->flattenedPositions()[0], Vec2f(200.0f, 0.0f), 0.01f));
+        EXPECT(!isClose(p2->length(), circumference, 0.1f));
+
+        Path * p4 = p2->clone();
+        p4->flatten();
+        EXPECT(p4->segmentCount() == p2->flattenedPositions().count());
+
+        // flattening with and without a warm cache gives the same segments
+        Path * p5 = p2->clone();
+        p5->flattenedPositions();
+        p5->flatten();
+        EXPECT(p5->segmentCount() == p4->segmentCount());
+        EXPECT(p5->flattenedPositions().count() == p5->segmentCount());
     },
     SUITE("Path Orientation Tests")
     {
@@ -289,6 +364,72 @@ const Suite spec[] =
         EXPECT(isClose(bounds5.width(), diagonal * 2 + 40.0f, 0.00001f));
         EXPECT(isClose(bounds5.height(), diagonal * 2 + 40.0f, 0.00001f));
     },
+    SUITE("Stroke Join And Cap Bounds Tests")
+    {
+        Document doc;
+
+        // a triangle is no shape, so the joins are merged one by one
+        Path * tri = doc.createPath();
+        tri->addPoint(Vec2f(0.0f, 0.0f));
+        tri->addPoint(Vec2f(100.0f, 0.0f));
+        tri->addPoint(Vec2f(0.0f, 100.0f));
+        tri->closePath();
+        tri->setStroke(ColorRGBA(0.0f, 0.0f, 0.0f, 1.0f));
+        tri->setStrokeWidth(10.0f);
+        tri->setMiterLimit(10.0f);
+        tri->setStrokeJoin(StrokeJoin::Miter);
+
+        // the miters of the 45 degree corners reach 5 * (1 + sqrt(2)) past the corner
+        Float tip = 100.0f + 5.0f * (1.0f + std::sqrt(2.0f));
+        EXPECT(isClose(tri->strokeBounds().min(), Vec2f(-5.0f), 0.001f));
+        EXPECT(isClose(tri->strokeBounds().max(), Vec2f(tip), 0.001f));
+
+        // the bevels stay within the padding
+        tri->setStrokeJoin(StrokeJoin::Bevel);
+        EXPECT(isClose(tri->strokeBounds().min(), Vec2f(-5.0f), 0.001f));
+        EXPECT(isClose(tri->strokeBounds().max(), Vec2f(105.0f), 0.001f));
+
+        // below the miter limit the miter falls back to a bevel
+        tri->setStrokeJoin(StrokeJoin::Miter);
+        tri->setMiterLimit(2.0f);
+        EXPECT(isClose(tri->strokeBounds().min(), Vec2f(-5.0f), 0.001f));
+        EXPECT(isClose(tri->strokeBounds().max(), Vec2f(105.0f), 0.001f));
+
+        // a single segment has no joins, its caps point along the x axis like in the outline
+        Path * dot = doc.createPath();
+        dot->addPoint(Vec2f(20.0f, 30.0f));
+        dot->setStroke(ColorRGBA(0.0f, 0.0f, 0.0f, 1.0f));
+        dot->setStrokeWidth(10.0f);
+        dot->setStrokeCap(StrokeCap::Square);
+        EXPECT(isClose(dot->strokeBounds().min(), Vec2f(15.0f, 25.0f), 0.001f));
+        EXPECT(isClose(dot->strokeBounds().max(), Vec2f(25.0f, 35.0f), 0.001f));
+        EXPECT(dot->strokeContains(Vec2f(24.0f, 34.0f)));
+        EXPECT(!dot->strokeContains(Vec2f(26.0f, 30.0f)));
+
+        dot->setStrokeCap(StrokeCap::Round);
+        EXPECT(isClose(dot->strokeBounds().min(), Vec2f(15.0f, 25.0f), 0.001f));
+        EXPECT(isClose(dot->strokeBounds().max(), Vec2f(25.0f, 35.0f), 0.001f));
+        EXPECT(dot->strokeContains(Vec2f(24.0f, 30.0f)));
+        EXPECT(!dot->strokeContains(Vec2f(24.0f, 34.0f)));
+
+        dot->setStrokeCap(StrokeCap::Butt);
+        EXPECT(dot->strokeBounds() == Rect(Vec2f(20.0f, 30.0f), Vec2f(20.0f, 30.0f)));
+        EXPECT(!dot->strokeContains(Vec2f(20.0f, 30.0f)));
+
+        // two segments only have the caps
+        Path * line = doc.createPath();
+        line->addPoint(Vec2f(0.0f, 0.0f));
+        line->addPoint(Vec2f(100.0f, 0.0f));
+        line->setStroke(ColorRGBA(0.0f, 0.0f, 0.0f, 1.0f));
+        line->setStrokeWidth(10.0f);
+        line->setStrokeJoin(StrokeJoin::Miter);
+        line->setStrokeCap(StrokeCap::Butt);
+        EXPECT(isClose(line->strokeBounds().min(), Vec2f(-5.0f, -5.0f), 0.001f));
+        EXPECT(isClose(line->strokeBounds().max(), Vec2f(105.0f, 5.0f), 0.001f));
+        line->setStrokeCap(StrokeCap::Square);
+        EXPECT(isClose(line->strokeBounds().min(), Vec2f(-5.0f, -5.0f), 0.001f));
+        EXPECT(isClose(line->strokeBounds().max(), Vec2f(105.0f, 5.0f), 0.001f));
+    },
     SUITE("Clone Tests")
     {
         Document doc;
@@ -330,6 +471,736 @@ const Suite spec[] =
 
         EXPECT(grp2->strokeBounds() == grp->strokeBounds());
         EXPECT(grp2->bounds() == grp->bounds());
+    },
+    SUITE("Intersection Tests")
+    {
+        Document doc;
+        Path * circle = doc.createCircle(Vec2f(100, 100), 100);
+
+        Path * line = doc.createPath();
+        line->addPoint(Vec2f(-100, 100));
+        line->addPoint(Vec2f(300, 100));
+        auto isecs = line->intersections(circle);
+        EXPECT(isecs.count() == 2);
+
+        // only the first curve of this path reaches into the circle, all the others
+        // should be rejected by the broadphase.
+        Path * zigzag = doc.createPath();
+        zigzag->addPoint(Vec2f(150, 100));
+        for (Int32 i = 0; i < 100; ++i)
+            zigzag->addPoint(Vec2f(250 + i * 10, i % 2 ? 90 : 110));
+        auto isecs2 = zigzag->intersections(circle);
+        EXPECT(isecs2.count() == 1);
+        EXPECT(isecs2[0].location.curve().index() == 0);
+
+        Path * farAway = doc.createPath();
+        farAway->addPoint(Vec2f(1000, 1000));
+        farAway->addPoint(Vec2f(1100, 1100));
+        EXPECT(farAway->intersections(circle).count() == 0);
+
+        // this line passes through two segments of the circle, each of these intersections
+        // is found on both adjacent curves but should only be reported once.
+        Path * vertical = doc.createPath();
+        vertical->addPoint(Vec2f(100, -100));
+        vertical->addPoint(Vec2f(100, 300));
+        EXPECT(circle->intersections(vertical).count() == 2);
+
+        // moving the line onto the far away path should give the same result as moving the
+        // path itself, the transformed segments are never copied.
+        Path * movedLine = line->clone();
+        movedLine->translateTransform(Vec2f(1050, 950));
+        Path * movedCircle = circle->clone();
+        movedCircle->translateTransform(Vec2f(1000, 0));
+        EXPECT(movedLine->intersections(farAway).count() == 1);
+        Path * movedVertical = vertical->clone();
+        movedVertical->translateTransform(Vec2f(1000, 0));
+        EXPECT(movedCircle->intersections(movedVertical).count() == 2);
+        EXPECT(movedCircle->intersections(vertical).count() == 0);
+        EXPECT(crunch::isClose(
+            movedCircle->closestPoint(Vec2f(1100, 250)), Vec2f(1100, 200), 0.001f));
+
+        // intersecting all paths at once should give the same result as the pairwise api
+        const Path * paths[] = { circle, line, zigzag, farAway, vertical };
+        IntersectionArray expected;
+        for (Size i = 0; i < 5; ++i)
+            for (Size j = i + 1; j < 5; ++j)
+                for (const Intersection & isec : paths[i]->intersections(paths[j]))
+                    expected.append(isec);
+
+        for (bool bMultithreaded : { false, true })
+        {
+            auto all = doc.intersectAll(paths, 5, bMultithreaded);
+            EXPECT(all.count() == expected.count());
+            for (Size i = 0; i < stick::min(all.count(), expected.count()); ++i)
+            {
+                EXPECT(all[i].location == expected[i].location);
+                EXPECT(crunch::isClose(all[i].position, expected[i].position, 0.001f));
+            }
+        }
+
+        // compound paths on both sides, the nested paths are visited in the same order
+        Path * frame = doc.createRectangle(Vec2f(0, 0), Vec2f(100, 100));
+        Path * frameHole = doc.createRectangle(Vec2f(20, 20), Vec2f(80, 80));
+        frame->addChild(frameHole);
+        frameHole->addChild(doc.createRectangle(Vec2f(40, 40), Vec2f(60, 60)));
+        Path * bars = doc.createRectangle(Vec2f(-10, 10), Vec2f(110, 30));
+        bars->addChild(doc.createRectangle(Vec2f(-10, 45), Vec2f(110, 55)));
+        bars->addChild(doc.createRectangle(Vec2f(-10, 70), Vec2f(110, 90)));
+        Path * diagonal = doc.createPath();
+        diagonal->addPoint(Vec2f(-20, -10));
+        diagonal->addPoint(Vec2f(120, 110));
+        const Path * compounds[] = { frame, bars, diagonal };
+        IntersectionArray expectedCompound;
+        for (Size i = 0; i < 3; ++i)
+            for (Size j = i + 1; j < 3; ++j)
+                for (const Intersection & isec : compounds[i]->intersections(compounds[j]))
+                    expectedCompound.append(isec);
+        EXPECT(expectedCompound.count() > 0);
+
+        for (bool bMultithreaded : { false, true })
+        {
+            auto all = doc.intersectAll(compounds, 3, bMultithreaded);
+            EXPECT(all.count() == expectedCompound.count());
+            for (Size i = 0; i < stick::min(all.count(), expectedCompound.count()); ++i)
+            {
+                EXPECT(all[i].location == expectedCompound[i].location);
+                EXPECT(crunch::isClose(all[i].position, expectedCompound[i].position, 0.001f));
+            }
+        }
+    },
+    SUITE("Self Intersection Tests")
+    {
+        Document doc;
+        Path * circle = doc.createCircle(Vec2f(100, 100), 100);
+        EXPECT(circle->intersectionsLocal().count() == 0);
+
+        Path * bowTie = doc.createPath();
+        bowTie->addPoint(Vec2f(0, 0));
+        bowTie->addPoint(Vec2f(100, 100));
+        bowTie->addPoint(Vec2f(100, 0));
+        bowTie->addPoint(Vec2f(0, 100));
+        bowTie->closePath();
+        auto isecs = bowTie->intersectionsLocal();
+        EXPECT(isecs.count() == 1);
+        EXPECT(isecs[0].location.curve().index() == 0);
+        EXPECT(crunch::isClose(isecs[0].position, Vec2f(50, 50), 0.001f));
+
+        // adjacent curves only touch where they connect, so this should not report anything.
+        Path * zigzag = doc.createPath();
+        for (Int32 i = 0; i < 200; ++i)
+            zigzag->addPoint(Vec2f(i * 10, i % 2 ? 90 : 110));
+        EXPECT(zigzag->intersectionsLocal().count() == 0);
+
+        // going back crosses all curves of the zigzag
+        zigzag->addPoint(Vec2f(1990, 100));
+        zigzag->addPoint(Vec2f(-10, 100));
+        EXPECT(zigzag->intersectionsLocal().count() == 199);
+
+        // intersections between the children of a compound path
+        Path * compound = doc.createCircle(Vec2f(100, 100), 100);
+        compound->addChild(doc.createCircle(Vec2f(200, 100), 100));
+        EXPECT(compound->intersectionsLocal().count() == 2);
+    },
+    SUITE("Boolean Operation Tests")
+    {
+        Document doc;
+        Path * a = doc.createRectangle(Vec2f(0, 0), Vec2f(100, 100));
+        Path * b = doc.createRectangle(Vec2f(50, 50), Vec2f(150, 150));
+
+        Path * united = a->unite(b);
+        EXPECT(united->segmentCount() == 8);
+        EXPECT(united->children().count() == 0);
+        EXPECT(isClose(std::abs(united->area()), 17500.0f, 0.1f));
+
+        Path * intersected = a->intersect(b);
+        EXPECT(intersected->segmentCount() == 4);
+        EXPECT(isClose(std::abs(intersected->area()), 2500.0f, 0.1f));
+
+        Path * subtracted = a->subtract(b);
+        EXPECT(subtracted->segmentCount() == 6);
+        EXPECT(isClose(std::abs(subtracted->area()), 7500.0f, 0.1f));
+        EXPECT(subtracted->contains(Vec2f(25, 25)));
+        EXPECT(!subtracted->contains(Vec2f(75, 75)));
+
+        Path * excluded = a->exclude(b);
+        EXPECT(isClose(std::abs(excluded->area()), 15000.0f, 0.1f));
+        EXPECT(!excluded->contains(Vec2f(75, 75)));
+
+        Path * divided = a->divide(b);
+        EXPECT(divided->children().count() == 1);
+        EXPECT(isClose(std::abs(divided->area()), 10000.0f, 0.1f));
+
+        // no intersections, the hole is kept as a child with the opposite orientation
+        Path * hole = doc.createRectangle(Vec2f(40, 40), Vec2f(60, 60));
+        Path * withHole = a->subtract(hole);
+        EXPECT(withHole->children().count() == 1);
+        EXPECT(isClose(std::abs(withHole->area()), 9600.0f, 0.1f));
+        EXPECT(!withHole->contains(Vec2f(50, 50)));
+
+        Path * farAway = doc.createRectangle(Vec2f(200, 200), Vec2f(300, 300));
+        EXPECT(a->intersect(farAway)->segmentCount() == 0);
+        EXPECT(isClose(std::abs(a->unite(farAway)->area()), 20000.0f, 0.1f));
+
+        // curved operands
+        Path * circleA = doc.createCircle(Vec2f(0, 0), 100);
+        Path * circleB = doc.createCircle(Vec2f(100, 0), 100);
+        Path * lens = circleA->intersect(circleB);
+        // area of the lens of two circles with radius r and center distance r
+        Float r = 100;
+        Float expected = r * r * (2.0f * crunch::Constants<Float>::pi() / 3.0f - std::sqrt(3.0f) / 2.0f);
+        EXPECT(isClose(std::abs(lens->area()), expected, expected * 0.01f));
+        EXPECT(isClose(std::abs(circleA->unite(circleB)->area()),
+                       std::abs(circleA->area()) * 2.0f - expected,
+                       expected * 0.01f));
+
+        // adjacent tiles share an edge, it is only traced once
+        Path * right = doc.createRectangle(Vec2f(100, 0), Vec2f(200, 100));
+        Path * tiles = a->unite(right);
+        EXPECT(tiles->children().count() == 0);
+        EXPECT(isClose(std::abs(tiles->area()), 20000.0f, 0.1f));
+        EXPECT(tiles->contains(Vec2f(100, 50)));
+        EXPECT(a->intersect(right)->segmentCount() == 0);
+        EXPECT(isClose(std::abs(a->subtract(right)->area()), 10000.0f, 0.1f));
+
+        // the shared part of the edge is shorter than the edges
+        Path * shifted = doc.createRectangle(Vec2f(100, 50), Vec2f(200, 150));
+        Path * stairs = a->unite(shifted);
+        EXPECT(stairs->children().count() == 0);
+        EXPECT(isClose(std::abs(stairs->area()), 20000.0f, 0.1f));
+        EXPECT(stairs->contains(Vec2f(100, 75)));
+        EXPECT(!stairs->contains(Vec2f(150, 25)));
+        EXPECT(!stairs->contains(Vec2f(50, 125)));
+
+        // a self intersecting operand is split where it crosses itself
+        Path * bowTie = doc.createPath();
+        bowTie->addPoint(Vec2f(0, 0));
+        bowTie->addPoint(Vec2f(100, 100));
+        bowTie->addPoint(Vec2f(100, 0));
+        bowTie->addPoint(Vec2f(0, 100));
+        bowTie->closePath();
+        Path * big = doc.createRectangle(Vec2f(-50, -50), Vec2f(150, 150));
+        Path * clipped = bowTie->intersect(big);
+        EXPECT(isClose(std::abs(clipped->area()), 5000.0f, 0.1f));
+        EXPECT(clipped->contains(Vec2f(20, 50)));
+        EXPECT(clipped->contains(Vec2f(80, 50)));
+        EXPECT(!clipped->contains(Vec2f(50, 20)));
+    },
+    SUITE("Contains Tests")
+    {
+        Document doc;
+
+        // comb with 50 teeth, enough curves for the y index to kick in
+        Path * comb = doc.createPath();
+        comb->addPoint(Vec2f(0, 0));
+        for (Size i = 0; i < 50; ++i)
+        {
+            comb->addPoint(Vec2f(i * 20, 100));
+            comb->addPoint(Vec2f(i * 20 + 10, 200));
+            comb->addPoint(Vec2f(i * 20 + 20, 100));
+        }
+        comb->addPoint(Vec2f(1000, 0));
+        comb->closePath();
+
+        EXPECT(comb->contains(Vec2f(500, 50)));
+        EXPECT(comb->contains(Vec2f(10, 150)));
+        EXPECT(comb->contains(Vec2f(990, 190)));
+        EXPECT(!comb->contains(Vec2f(20, 150)));
+        EXPECT(!comb->contains(Vec2f(500, 199)));
+        EXPECT(!comb->contains(Vec2f(500, 250)));
+        EXPECT(!comb->contains(Vec2f(500, -10)));
+
+        // points on the outline count as inside
+        EXPECT(comb->contains(Vec2f(500, 0)));
+        EXPECT(comb->contains(Vec2f(10, 200)));
+
+        // holes in compound paths
+        Path * circle = doc.createCircle(Vec2f(0, 0), 100);
+        circle->addChild(doc.createCircle(Vec2f(0, 0), 50));
+        circle->flatten(0.01f, true);
+        EXPECT(circle->contains(Vec2f(75, 0)));
+        EXPECT(!circle->contains(Vec2f(0, 0)));
+        EXPECT(!circle->contains(Vec2f(0, 120)));
+
+        // bulk classification has to match single queries
+        DynamicArray<Vec2f> points;
+        for (Size y = 0; y < 30; ++y)
+            for (Size x = 0; x < 30; ++x)
+                points.append(Vec2f(x * 40.0f - 100.0f, y * 10.0f - 50.0f));
+        DynamicArray<bool> results(points.count() * 2);
+        const Path * paths[] = { comb, circle };
+        doc.contains(paths, 2, &points[0], points.count(), &results[0], true);
+        bool bAllSame = true;
+        for (Size i = 0; i < points.count(); ++i)
+        {
+            bAllSame &= results[i] == comb->contains(points[i]);
+            bAllSame &= results[points.count() + i] == circle->contains(points[i]);
+        }
+        EXPECT(bAllSame);
+        comb->contains(&points[0], points.count(), &results[0]);
+        EXPECT(results[0] == comb->contains(points[0]));
+
+        // transformed queries test against the untransformed cached curves
+        EXPECT(comb->contains(Vec2f(500, 1050), Mat32f::translation(Vec2f(0, 1000))));
+        EXPECT(!comb->contains(Vec2f(500, 50), Mat32f::translation(Vec2f(0, 1000))));
+        comb->translateTransform(Vec2f(1000, 0));
+        EXPECT(comb->contains(Vec2f(1500, 50)));
+        EXPECT(!comb->contains(Vec2f(500, 50)));
+        Vec2f moved[] = { Vec2f(1500, 50), Vec2f(500, 50) };
+        comb->contains(moved, 2, &results[0]);
+        EXPECT(results[0] && !results[1]);
+
+        // the early out has to happen in item space, too
+        Path * triangle = doc.createPath();
+        triangle->addPoint(Vec2f(100, 100));
+        triangle->addPoint(Vec2f(200, 100));
+        triangle->addPoint(Vec2f(150, 200));
+        triangle->closePath();
+        triangle->translateTransform(Vec2f(1000, 0));
+        EXPECT(triangle->contains(Vec2f(1150, 150)));
+        EXPECT(!triangle->contains(Vec2f(150, 150)));
+        Vec2f triPoints[] = { Vec2f(1150, 150), Vec2f(150, 150) };
+        triangle->contains(triPoints, 2, &results[0]);
+        EXPECT(results[0] && !results[1]);
+        EXPECT(triangle->handleBounds() == Rect(Vec2f(1100, 100), Vec2f(1200, 200)));
+
+        // geometry changes of nested children reach the cache of the outermost path
+        Path * outer = doc.createRectangle(Vec2f(0, 0), Vec2f(100, 100));
+        Path * inner = doc.createRectangle(Vec2f(200, 0), Vec2f(300, 100));
+        Path * innermost = doc.createRectangle(Vec2f(400, 0), Vec2f(500, 100));
+        outer->addChild(inner);
+        inner->addChild(innermost);
+        EXPECT(outer->contains(Vec2f(450, 50)));
+        for (Size i = 0; i < innermost->segmentCount(); ++i)
+            innermost->segment(i).setPosition(innermost->segment(i).position() + Vec2f(200, 0));
+        EXPECT(!outer->contains(Vec2f(450, 50)));
+        EXPECT(outer->contains(Vec2f(650, 50)));
+        outer->addChild(doc.createRectangle(Vec2f(800, 0), Vec2f(900, 100)));
+        EXPECT(outer->contains(Vec2f(850, 50)));
+    },
+    SUITE("Stroke Outline Tests")
+    {
+        Document doc;
+        Path * rect = doc.createRectangle(Vec2f(0, 0), Vec2f(100, 100));
+        rect->setStroke(ColorRGBA(1, 0, 0, 1));
+        rect->setStrokeWidth(10);
+        rect->setStrokeJoin(StrokeJoin::Miter);
+
+        // a closed path has an outline for each side of the stroke
+        const PolygonArray & outline = rect->strokeOutlineLocal();
+        EXPECT(outline.count() == 2);
+        EXPECT(&rect->strokeOutlineLocal() == &outline);
+
+        Path * filled = rect->strokeOutline();
+        EXPECT(filled->fill().is<ColorRGBA>());
+        EXPECT(filled->stroke().is<NoPaint>());
+        EXPECT(filled->contains(Vec2f(50, 3)));
+        EXPECT(filled->contains(Vec2f(-4, -4)));
+        EXPECT(!filled->contains(Vec2f(50, 50)));
+        EXPECT(!filled->contains(Vec2f(50, -6)));
+        EXPECT(isClose(filled->bounds().min(), Vec2f(-5, -5), 0.001f));
+
+        // bevel joins cut the corners off
+        rect->setStrokeJoin(StrokeJoin::Bevel);
+        Path * beveled = rect->strokeOutline();
+        EXPECT(beveled->contains(Vec2f(-2, 50)));
+        EXPECT(!beveled->contains(Vec2f(-4, -4)));
+
+        // an open line with butt caps and a dash pattern
+        Path * line = doc.createPath();
+        line->addPoint(Vec2f(0, 0));
+        line->addPoint(Vec2f(100, 0));
+        line->setStrokeWidth(4);
+        line->setStrokeCap(StrokeCap::Butt);
+        EXPECT(line->strokeOutlineLocal().count() == 1);
+        DashArray dashes;
+        dashes.append(10);
+        dashes.append(15);
+        line->setDashArray(dashes);
+        EXPECT(line->strokeOutlineLocal().count() == 4);
+        Path * dashed = line->strokeOutline();
+        EXPECT(dashed->contains(Vec2f(5, 1)));
+        EXPECT(!dashed->contains(Vec2f(15, 1)));
+
+        // the outline follows geometry changes
+        line->segment(1).setPosition(Vec2f(20, 0));
+        EXPECT(line->strokeOutlineLocal().count() == 1);
+
+        // hit testing a wide stroke away from the curve itself
+        EXPECT(rect->strokeContains(Vec2f(50, 4)));
+        EXPECT(!rect->strokeContains(Vec2f(50, 6)));
+        EXPECT(!rect->strokeContains(Vec2f(50, 50)));
+        EXPECT(rect->strokeContains(Vec2f(54, 4), Mat32f::translation(Vec2f(4, 0))));
+        // stroke hit testing is opt in
+        HitTestSettings settings;
+        EXPECT(!settings.testStroke());
+        EXPECT(!rect->hitTest(Vec2f(50, 4), settings));
+        settings.mode |= HitTestStroke;
+        auto hit = rect->hitTest(Vec2f(50, 4), settings);
+        EXPECT(hit && hit->item == rect && hit->type == HitTestStroke);
+        settings.mode = HitTestCurves;
+        EXPECT(!rect->hitTest(Vec2f(50, 4), settings));
+    },
+    SUITE("Dash Tests")
+    {
+        Document doc;
+        Path * line = doc.createPath();
+        line->addPoint(Vec2f(0, 0));
+        line->addPoint(Vec2f(100, 0));
+        DashArray dashes;
+        dashes.append(10);
+        dashes.append(15);
+
+        // dashes at 0, 25, 50 and 75
+        Path * dashed = line->dashed(dashes, 0);
+        EXPECT(dashed->children().count() == 3);
+        EXPECT(!dashed->isClosed());
+        EXPECT(dashed->fill().is<NoPaint>());
+        EXPECT(isClose(dashed->segment(0).position(), Vec2f(0, 0), 0.001f));
+        EXPECT(isClose(dashed->segment(1).position(), Vec2f(10, 0), 0.001f));
+        Path * last = static_cast<Path *>(dashed->children().last());
+        EXPECT(isClose(last->segment(0).position(), Vec2f(75, 0), 0.001f));
+        EXPECT(isClose(last->segment(1).position(), Vec2f(85, 0), 0.001f));
+
+        // the offset shifts the pattern along the path, the last dash is cut off
+        Path * shifted = line->dashed(dashes, 5);
+        EXPECT(shifted->children().count() == 4);
+        EXPECT(isClose(shifted->segment(1).position(), Vec2f(5, 0), 0.001f));
+        last = static_cast<Path *>(shifted->children().last());
+        EXPECT(isClose(last->segment(0).position(), Vec2f(95, 0), 0.001f));
+        EXPECT(isClose(last->segment(1).position(), Vec2f(100, 0), 0.001f));
+
+        // dashes follow the curves
+        Path * circle = doc.createCircle(Vec2f(0, 0), 50);
+        DashArray even;
+        even.append(10);
+        circle->setDashArray(even);
+        Path * dashedCircle = circle->dashed();
+        EXPECT(dashedCircle->children().count() == 15);
+        EXPECT(dashedCircle->dashArray().count() == 0);
+        Float len = dashedCircle->length();
+        for (Item * c : dashedCircle->children())
+        {
+            Path * p = static_cast<Path *>(c);
+            EXPECT(isClose(crunch::length(p->segmentData().last().position), 50.0f, 0.05f));
+            len += p->length();
+        }
+        EXPECT(isClose(len, 160.0f, 0.1f));
+
+        // transformed children are dashed in the space of the compound path
+        Path * compound = line->clone();
+        Path * child = doc.createPath();
+        child->addPoint(Vec2f(0, 10));
+        child->addPoint(Vec2f(50, 10));
+        child->setTransform(Mat32f::scaling(2.0f));
+        compound->addChild(child);
+        Path * dashedCompound = compound->dashed(dashes, 0);
+        EXPECT(dashedCompound->children().count() == 7);
+        Path * childDash = static_cast<Path *>(dashedCompound->children()[3]);
+        EXPECT(isClose(childDash->segment(0).position(), Vec2f(0, 20), 0.001f));
+        EXPECT(isClose(childDash->segment(1).position(), Vec2f(10, 20), 0.001f));
+        last = static_cast<Path *>(dashedCompound->children().last());
+        EXPECT(isClose(last->segment(0).position(), Vec2f(75, 20), 0.001f));
+        EXPECT(isClose(last->segment(1).position(), Vec2f(85, 20), 0.001f));
+
+        // no dashing copies the contours
+        Path * copy = circle->dashed(DashArray(), 0);
+        EXPECT(copy->isClosed());
+        EXPECT(copy->segmentData().count() == circle->segmentData().count());
+    },
+    SUITE("Streaming Path Fitter Tests")
+    {
+        Document doc;
+        Path * path = doc.createPath();
+        StreamingPathFitter fitter(path, 2.5);
+
+        // a wave drawn one point at a time
+        stick::DynamicArray<Vec2f> points;
+        for (Size i = 0; i < 500; ++i)
+            points.append(Vec2f(i * 2.0f, std::sin(i * 0.05f) * 100.0f));
+
+        Size finished = 0;
+        SegmentDataArray finishedSegments;
+        for (Size i = 0; i < points.count(); ++i)
+        {
+            fitter.addPoint(points[i]);
+            fitter.addPoint(points[i]); // duplicates are ignored
+            EXPECT(fitter.finishedSegmentCount() >= finished);
+            EXPECT(fitter.finishedSegmentCount() <= path->segmentData().count());
+            EXPECT(path->segmentData()[0].position == points[0]);
+            EXPECT(path->segmentData().last().position == points[i]);
+            finished = fitter.finishedSegmentCount();
+            if (!finishedSegments.count() && finished > 2)
+                finishedSegments.insert(finishedSegments.end(),
+                                        path->segmentData().begin(),
+                                        path->segmentData().begin() + finished - 1);
+        }
+
+        // the wave needs a bunch of curves, only the trailing points are still pending
+        EXPECT(finished > 2);
+        EXPECT(fitter.pendingPointCount() < points.count() / 2);
+
+        // finished segments don't change anymore
+        for (Size i = 0; i < finishedSegments.count(); ++i)
+        {
+            EXPECT(finishedSegments[i].position == path->segmentData()[i].position);
+            EXPECT(finishedSegments[i].handleIn == path->segmentData()[i].handleIn);
+            EXPECT(finishedSegments[i].handleOut == path->segmentData()[i].handleOut);
+        }
+
+        fitter.finish();
+        EXPECT(fitter.finishedSegmentCount() == path->segmentData().count());
+        EXPECT(fitter.pendingPointCount() == 1);
+        for (const Vec2f & p : points)
+        {
+            Float dist;
+            path->closestPoint(p, dist);
+            EXPECT(dist < 2.5f);
+        }
+
+        // a long straight line does not keep all of its points pending
+        Path * line = doc.createPath();
+        StreamingPathFitter lineFitter(line);
+        for (Size i = 0; i < 1000; ++i)
+            lineFitter.addPoint(Vec2f(i, i * 0.5f));
+        EXPECT(lineFitter.pendingPointCount() <= 257);
+        EXPECT(lineFitter.finishedSegmentCount() > 1);
+    },
+    SUITE("Batch Path Operation Tests")
+    {
+        Document doc;
+        auto makePaths = [&doc](DynamicArray<Path *> & _out)
+        {
+            for (Size i = 0; i < 40; ++i)
+            {
+                Path * p = doc.createPath();
+                for (Size j = 0; j < 50 + i * 10; ++j)
+                    p->addPoint(Vec2f(j * 3.0f, std::sin(j * 0.1f + i) * (20.0f + i)));
+                if (i % 2)
+                    p->closePath();
+                _out.append(p);
+            }
+            _out.append(doc.createCircle(Vec2f(50, 50), 30));
+            _out.append(doc.createPath());
+        };
+
+        DynamicArray<Path *> serial, batch;
+        makePaths(serial);
+        makePaths(batch);
+
+        // the batch results have to be identical to processing one path after another
+        for (Path * p : serial)
+            p->simplify(3.0f);
+        doc.simplifyPaths(&batch[0], batch.count(), 3.0f, true);
+        for (Path * p : serial)
+            p->flatten(0.1f);
+        doc.flattenPaths(&batch[0], batch.count(), 0.1f, 0.0f, 32, true);
+        for (Path * p : serial)
+            p->smooth(Smoothing::Continuous);
+        doc.smoothPaths(&batch[0], batch.count(), Smoothing::Continuous, true);
+
+        for (Size i = 0; i < serial.count(); ++i)
+        {
+            const auto & a = serial[i]->segmentData();
+            const auto & b = batch[i]->segmentData();
+            EXPECT(a.count() == b.count());
+            EXPECT(serial[i]->isClosed() == batch[i]->isClosed());
+            bool bSame = a.count() == b.count();
+            for (Size j = 0; bSame && j < a.count(); ++j)
+                bSame = a[j].position == b[j].position && a[j].handleIn == b[j].handleIn &&
+                        a[j].handleOut == b[j].handleOut;
+            EXPECT(bSame);
+            EXPECT(serial[i]->curveData().count() == batch[i]->curveData().count());
+        }
+        EXPECT(isClose(serial[0]->bounds().min(), batch[0]->bounds().min()));
+    },
+    SUITE("Smooth Tests")
+    {
+        Document doc;
+        for (Smoothing type : { Smoothing::Asymmetric, Smoothing::Continuous })
+        {
+            for (Size idx : { 0, 3, 50, 97, 99 })
+            {
+                Path * full = doc.createPath();
+                for (Size i = 0; i < 100; ++i)
+                    full->addPoint(Vec2f(i * 10.0f, std::sin(i * 0.4f) * 40.0f));
+                full->smooth(type);
+                Path * local = full->clone();
+                SegmentDataArray before = local->segmentData();
+
+                // moving a segment and smoothing its neighbourhood should come close to
+                // smoothing the whole path again
+                full->segment(idx).setPosition(full->segment(idx).position() + Vec2f(5, -12));
+                local->segment(idx).setPosition(local->segment(idx).position() + Vec2f(5, -12));
+                full->smooth(type);
+                local->smoothAround(idx, idx, type);
+
+                bool bClose = true;
+                bool bUntouched = true;
+                for (Size i = 0; i < 100; ++i)
+                {
+                    const SegmentData & a = full->segmentData()[i];
+                    const SegmentData & b = local->segmentData()[i];
+                    bClose = bClose && isClose(a.handleIn, b.handleIn, 0.01f) &&
+                             isClose(a.handleOut, b.handleOut, 0.01f);
+                    if (i + 9 < idx || i > idx + 9)
+                        bUntouched = bUntouched && b.handleIn == before[i].handleIn &&
+                                     b.handleOut == before[i].handleOut;
+                }
+                EXPECT(bClose);
+                EXPECT(bUntouched);
+                EXPECT(isClose(full->length(), local->length(), 0.01f));
+            }
+        }
+    },
+    SUITE("Shape Tests")
+    {
+        Document doc;
+        Path * shapes[] = { doc.createRectangle(Vec2f(10, 20), Vec2f(110, 70)),
+                            doc.createCircle(Vec2f(50, 60), 40),
+                            doc.createEllipse(Vec2f(-30, 10), Vec2f(80, 40)),
+                            doc.createRoundedRectangle(Vec2f(0), Vec2f(100, 60), Vec2f(10, 20)) };
+
+        // the twins have the same outline with one more segment, so they are not recognized as
+        // shapes and answer the queries with the bezier math.
+        Path * twins[4];
+        for (Size i = 0; i < 4; ++i)
+        {
+            twins[i] = shapes[i]->clone();
+            twins[i]->curves()[0].divideAtParameter(0.5);
+        }
+
+        auto compare = [&](Path * _shape, Path * _twin) {
+            EXPECT(isClose(_shape->area(), _twin->area(), 0.01f));
+            EXPECT(_shape->isClockwise() == _twin->isClockwise());
+            EXPECT(isClose(_shape->length(), _twin->length(), 0.01f));
+            // the length is the last curve offset, which positionAt and slice rely on
+            Float curveLength = 0;
+            for (Size i = 0; i < _shape->curveCount(); ++i)
+                curveLength += _shape->curve(i).length();
+            EXPECT(_shape->length() == curveLength);
+            EXPECT(isClose(_shape->bounds().min(), _twin->bounds().min(), 0.001f));
+            EXPECT(isClose(_shape->bounds().max(), _twin->bounds().max(), 0.001f));
+
+            bool bSameContains = true;
+            bool bSameClosest = true;
+            for (Size y = 0; y < 30; ++y)
+            {
+                for (Size x = 0; x < 30; ++x)
+                {
+                    Vec2f p(x * 7.0f - 60.0f, y * 7.0f - 40.0f);
+                    Float a, b;
+                    Vec2f ca = _shape->closestPoint(p, a);
+                    Vec2f cb = _twin->closestPoint(p, b);
+                    bSameClosest = bSameClosest && isClose(a, b, 0.02f) && isClose(ca, cb, 0.05f);
+                    // the ideal circle differs from the curves right at the outline
+                    if (b > 0.1f)
+                        bSameContains = bSameContains && _shape->contains(p) == _twin->contains(p);
+                }
+            }
+            EXPECT(bSameContains);
+            EXPECT(bSameClosest);
+        };
+
+        for (Size i = 0; i < 4; ++i)
+            compare(shapes[i], twins[i]);
+
+        // translations, scales and flips keep the shapes axis aligned
+        for (Size i = 0; i < 4; ++i)
+        {
+            for (Path * p : { shapes[i], twins[i] })
+            {
+                p->translateTransform(Vec2f(15, -5));
+                p->scaleTransform(Vec2f(-1.5f, 0.5f));
+            }
+            compare(shapes[i], twins[i]);
+        }
+
+        // rotated shapes fall back to the curves
+        for (Size i = 0; i < 4; ++i)
+        {
+            shapes[i]->rotateTransform(0.3f);
+            twins[i]->rotateTransform(0.3f);
+            EXPECT(isClose(shapes[i]->bounds().min(), twins[i]->bounds().min(), 0.001f));
+            EXPECT(isClose(shapes[i]->bounds().max(), twins[i]->bounds().max(), 0.001f));
+        }
+
+        // the stroke of an axis aligned rectangle reaches half the stroke width past each side
+        Path * rect = doc.createRectangle(Vec2f(10, 20), Vec2f(110, 70));
+        rect->setStroke(ColorRGBA(1.0f, 1.0f, 1.0f, 1.0f));
+        rect->setStrokeWidth(10.0f);
+        rect->setStrokeJoin(StrokeJoin::Miter);
+        EXPECT(isClose(rect->strokeBounds().min(), Vec2f(5, 15)));
+        EXPECT(isClose(rect->strokeBounds().max(), Vec2f(115, 75)));
+
+        // editing the segments drops the recognized shape
+        Path * circle = doc.createCircle(Vec2f(50, 60), 40);
+        EXPECT(isClose(circle->area(), twins[1]->area(), 0.01f));
+        circle->segment(0).setPosition(circle->segment(0).position() + Vec2f(20, 0));
+        Float area = 0;
+        for (Curve c : circle->curves())
+            area += c.area();
+        EXPECT(isClose(circle->area(), area));
+        EXPECT(!circle->contains(Vec2f(50, 60) + Vec2f(105, 0)));
+        EXPECT(circle->contains(Vec2f(50, 60) + Vec2f(55, 0)));
+    },
+    SUITE("Moments Tests")
+    {
+        Document doc;
+        Path * rect = doc.createRectangle(Vec2f(10, 20), Vec2f(110, 70));
+        Moments m = rect->moments();
+        EXPECT(isClose(m.area, 5000.0f, 0.01f));
+        EXPECT(isClose(rect->centroid(), Vec2f(60, 45), 0.001f));
+        // around the centroid the second moments are w^3 * h / 12 and w * h^3 / 12
+        EXPECT(isClose(m.second.x / m.area - 60.0f * 60.0f, 100.0f * 100.0f / 12.0f, 0.05f));
+        EXPECT(isClose(m.second.y / m.area - 45.0f * 45.0f, 50.0f * 50.0f / 12.0f, 0.05f));
+        EXPECT(isClose(m.product / m.area, 60.0f * 45.0f, 0.05f));
+
+        // reversing flips the signs but not the centroid
+        rect->reverse();
+        EXPECT(isClose(rect->moments().area, -5000.0f, 0.01f));
+        EXPECT(!rect->isClockwise());
+        EXPECT(isClose(rect->centroid(), Vec2f(60, 45), 0.001f));
+
+        Path * circle = doc.createCircle(Vec2f(50, 60), 40);
+        Float area = 0;
+        for (Curve c : circle->curves())
+            area += c.area();
+        EXPECT(isClose(circle->moments().area, area, 0.01f));
+        EXPECT(isClose(circle->area(), area, 0.01f));
+        EXPECT(isClose(circle->centroid(), Vec2f(50, 60), 0.001f));
+
+        // holes are subtracted, with the transform of the child applied
+        Path * outer = doc.createRectangle(Vec2f(0), Vec2f(100));
+        Path * hole = doc.createRectangle(Vec2f(0), Vec2f(20));
+        hole->reverse();
+        hole->translateTransform(Vec2f(70, 40));
+        outer->addChild(hole);
+        EXPECT(isClose(outer->area(), 9600.0f, 0.01f));
+        EXPECT(isClose(outer->centroid(), Vec2f(48.75f, 50.0f), 0.001f));
+
+        // the cached moments are dropped with the geometry
+        Path * tri = doc.createPath();
+        tri->addPoint(Vec2f(0, 0));
+        tri->addPoint(Vec2f(100, 0));
+        tri->addPoint(Vec2f(0, 100));
+        tri->closePath();
+        EXPECT(isClose(tri->area(), 5000.0f, 0.01f));
+        EXPECT(tri->isClockwise());
+        tri->segment(1).setPosition(Vec2f(200, 0));
+        EXPECT(isClose(tri->area(), 10000.0f, 0.01f));
+        EXPECT(isClose(tri->centroid(), Vec2f(200.0f / 3.0f, 100.0f / 3.0f), 0.001f));
+
+        // open paths are closed with a straight line, so moving them moves the centroid along
+        Path * open = doc.createPath();
+        open->addPoint(Vec2f(0, 0));
+        open->addPoint(Vec2f(100, 0));
+        open->addPoint(Vec2f(0, 100));
+        EXPECT(isClose(open->area(), 5000.0f, 0.01f));
+        EXPECT(isClose(open->centroid(), Vec2f(100.0f / 3.0f, 100.0f / 3.0f), 0.001f));
+        for (Size i = 0; i < open->segmentCount(); ++i)
+            open->segment(i).setPosition(open->segment(i).position() + Vec2f(500, 300));
+        EXPECT(isClose(open->area(), 5000.0f, 0.01f));
+        EXPECT(isClose(open->centroid(), Vec2f(1600.0f / 3.0f, 1000.0f / 3.0f), 0.001f));
     }
 // SUITE("SVG Export Tests")
 // {